@@ -27,6 +27,11 @@ YAML_GIT_REPOSITORY ?= https://gitlab.cc4s.org/cc4s/yaml-cpp.git
 BLAS_INCLUDE ?= -I${BLAS_PATH}/include
 BLAS_LDFLAGS ?= -L${BLAS_PATH}/lib -lopenblas
 
+# zlib ========================================================================
+# needed for elementsType CompressedBinaryFile, set ZLIB = no to build without
+ZLIB         ?= yes
+ZLIB_LDFLAGS ?= -lz
+
 # ScaLAPACK ===================================================================
 SCALAPACK_LDFLAGS ?= -L${SCALAPACK_PATH}/lib -lscalapack
 
@@ -2,6 +2,10 @@
 include etc/make/yaml.mk
 include etc/make/ctf.mk
 
+ifeq ($(ZLIB),yes)
+include etc/make/zlib.mk
+endif
+
 ifeq ($(ATRIP),yes)
 include etc/make/atrip-internal.mk
 endif
@@ -1,4 +1,5 @@
 SRC_FILES += \
+main/Main.cxx \
 main/Cc4s.cxx \
 main/Options.cxx \
 main/Writer.cxx \
@@ -6,13 +7,17 @@ main/Reader.cxx \
 main/Setting.cxx \
 main/Log.cxx \
 main/Timer.cxx \
+main/MemoryTracker.cxx \
+main/StepCache.cxx \
 main/TensorIo.cxx \
+main/ByteShuffleCodec.cxx \
 main/TensorSet.cxx \
 main/tcc/Tcc.cxx \
 main/engines/DryTensor.cxx \
 main/mixers/Mixer.cxx \
 main/mixers/LinearMixer.cxx \
 main/mixers/DiisMixer.cxx \
+main/mixers/AndersonMixer.cxx \
 main/algorithms/Algorithm.cxx \
 main/algorithms/Write.cxx \
 main/algorithms/Read.cxx \
@@ -24,6 +29,7 @@ main/algorithms/DimensionProperty.cxx \
 main/algorithms/NonZeroCondition.cxx \
 main/algorithms/VertexCoulombIntegrals.cxx \
 main/algorithms/SecondOrderPerturbationTheory.cxx \
+main/algorithms/FrozenNaturalOrbitals.cxx \
 main/algorithms/CoupledCluster.cxx \
 main/algorithms/coupledcluster/CoupledClusterMethod.cxx \
 main/algorithms/coupledcluster/Ccsd.cxx \
@@ -42,11 +48,9 @@ SRC_FILES += main/algorithms/perturbative-triples/src/atrip/Atrip.cxx
 CXXFLAGS  += -Isrc/main/algorithms/perturbative-triples/include/
 endif
 
+# unit tests, run with make unit-test
 TEST_SRC_FILES = \
-test/math/Antisymmetrize.cxx \
-test/math/Symmetrize.cxx \
-test/math/PermutaticxxnSign.cxx \
-test/math/TensorUnion.cxx \
-test/util/LapackGeneralEigenSystem.cxx \
-test/Test.cxx  \
-test/algorithms/UccsdAmplitudesFromCoulombIntegrals.cxx  \
+test/Test.cxx \
+test/ByteShuffleCodec.cxx \
+test/Node.cxx \
+test/AtripEnergy.cxx \
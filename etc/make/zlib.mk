@@ -0,0 +1,3 @@
+# zlib of the system, used for compressing tensor elements
+CXXFLAGS += -DHAVE_ZLIB
+LDFLAGS += $(ZLIB_LDFLAGS)
@@ -0,0 +1,167 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ByteShuffleCodec.hpp>
+#include <Exception.hpp>
+
+#include <cmath>
+#include <cstring>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace cc4s;
+
+bool ByteShuffleCodec::isAvailable() {
+#ifdef HAVE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::vector<char> ByteShuffleCodec::encode(
+  const Real<64> *values, const Natural<> count
+) {
+  if (!isAvailable()) THROW("Compression requires cc4s built with zlib");
+  constexpr Natural<> W(sizeof(Real<64>));
+  std::vector<std::vector<char>> streams(W);
+  auto bytes(reinterpret_cast<const char *>(values));
+  std::vector<int> complete(W);
+  #pragma omp parallel for
+  for (Natural<> b = 0; b < W; ++b) {
+    complete[b] = encodeStream(bytes + b, count, W, streams[b]);
+  }
+  for (Natural<> b(0); b < W; ++b) {
+    // only fails for insufficient memory
+    if (!complete[b]) THROW("Failed to compress data");
+  }
+  // concatenate streams, each preceded by its encoded size
+  std::vector<char> data;
+  for (auto &stream: streams) {
+    Natural<64> size(stream.size());
+    auto sizeBytes(reinterpret_cast<const char *>(&size));
+    data.insert(data.end(), sizeBytes, sizeBytes + sizeof(size));
+    data.insert(data.end(), stream.begin(), stream.end());
+  }
+  return data;
+}
+
+void ByteShuffleCodec::decode(
+  const std::vector<char> &data, Real<64> *values, const Natural<> count,
+  const SourceLocation &sourceLocation
+) {
+  if (!isAvailable()) {
+    THROW_LOCATION(
+      "Decompression requires cc4s built with zlib", sourceLocation
+    );
+  }
+  constexpr Natural<> W(sizeof(Real<64>));
+  // locate streams
+  std::vector<const char *> begins(W), ends(W);
+  const char *position(data.data()), *end(data.data() + data.size());
+  for (Natural<> b(0); b < W; ++b) {
+    Natural<64> size;
+    if (position + sizeof(size) > end) {
+      THROW_LOCATION("Truncated compressed data", sourceLocation);
+    }
+    std::memcpy(&size, position, sizeof(size));
+    position += sizeof(size);
+    if (size > static_cast<Natural<>>(end - position)) {
+      THROW_LOCATION("Truncated compressed data", sourceLocation);
+    }
+    begins[b] = position;
+    ends[b] = position + size;
+    position += size;
+  }
+  auto bytes(reinterpret_cast<char *>(values));
+  std::vector<int> complete(W);
+  #pragma omp parallel for
+  for (Natural<> b = 0; b < W; ++b) {
+    complete[b] = decodeStream(begins[b], ends[b], bytes + b, count, W);
+  }
+  for (Natural<> b(0); b < W; ++b) {
+    if (!complete[b]) {
+      THROW_LOCATION("Malformed compressed data", sourceLocation);
+    }
+  }
+}
+
+void ByteShuffleCodec::quantize(
+  Real<64> *values, const Natural<> count, const Real<64> errorBound
+) {
+  if (errorBound <= 0) return;
+  // power of two step, such that multiples have trailing zero mantissa bits
+  const Real<64> step(std::exp2(std::floor(std::log2(2*errorBound))));
+  #pragma omp parallel for
+  for (Natural<> i = 0; i < count; ++i) {
+    values[i] = std::round(values[i] / step) * step;
+  }
+}
+
+/**
+ * \brief Deflates count bytes separated by the given stride.
+ * Returns false if compression failed.
+ **/
+bool ByteShuffleCodec::encodeStream(
+  const char *bytes, const Natural<> count, const Natural<> stride,
+  std::vector<char> &stream
+) {
+#ifdef HAVE_ZLIB
+  std::vector<Bytef> shuffled(count);
+  for (Natural<> i(0); i < count; ++i) shuffled[i] = bytes[i*stride];
+  uLongf size(compressBound(count));
+  stream.resize(size);
+  if (
+    compress2(
+      reinterpret_cast<Bytef *>(stream.data()), &size,
+      shuffled.data(), count, Z_DEFAULT_COMPRESSION
+    ) != Z_OK
+  ) {
+    return false;
+  }
+  stream.resize(size);
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * \brief Inflates the stream [begin,end) into count bytes written with
+ * the given stride. Returns false if the stream is malformed or does not
+ * contain exactly count bytes.
+ **/
+bool ByteShuffleCodec::decodeStream(
+  const char *begin, const char *end,
+  char *bytes, const Natural<> count, const Natural<> stride
+) {
+#ifdef HAVE_ZLIB
+  std::vector<Bytef> shuffled(count);
+  uLongf size(count);
+  if (
+    uncompress(
+      shuffled.data(), &size,
+      reinterpret_cast<const Bytef *>(begin), end - begin
+    ) != Z_OK || size != count
+  ) {
+    return false;
+  }
+  for (Natural<> i(0); i < count; ++i) bytes[i*stride] = shuffled[i];
+  return true;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,76 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BYTE_SHUFFLE_CODEC_DEFINED
+#define BYTE_SHUFFLE_CODEC_DEFINED
+
+#include <Real.hpp>
+#include <Integer.hpp>
+#include <SourceLocation.hpp>
+
+#include <vector>
+
+namespace cc4s {
+  /**
+   * \brief Lossless codec for arrays of 64 bit reals.
+   * The bytes of all words are first shuffled into 8 streams, such that
+   * the slowly varying sign and exponent bytes are stored contiguously.
+   * Each stream is then compressed with zlib's deflate.
+   * Streams are encoded and decoded in parallel.
+   **/
+  class ByteShuffleCodec {
+  public:
+    /**
+     * \brief Returns whether cc4s was built with zlib, which is required
+     * for encoding and decoding.
+     **/
+    static bool isAvailable();
+
+    static std::vector<char> encode(
+      const Real<64> *values, const Natural<> count
+    );
+
+    /**
+     * \brief Decodes the given data into count values. Throws an exception
+     * if the data is malformed.
+     **/
+    static void decode(
+      const std::vector<char> &data, Real<64> *values, const Natural<> count,
+      const SourceLocation &sourceLocation
+    );
+
+    /**
+     * \brief Rounds the given values to multiples of the largest power of
+     * two not exceeding twice the given absolute error bound. The rounding
+     * error is at most errorBound while the trailing mantissa bytes vanish
+     * and compress well. Values are unchanged if errorBound is zero.
+     **/
+    static void quantize(
+      Real<64> *values, const Natural<> count, const Real<64> errorBound
+    );
+
+  protected:
+    static bool encodeStream(
+      const char *bytes, const Natural<> count, const Natural<> stride,
+      std::vector<char> &stream
+    );
+    static bool decodeStream(
+      const char *begin, const char *end,
+      char *bytes, const Natural<> count, const Natural<> stride
+    );
+  };
+}
+
+#endif
@@ -18,12 +18,17 @@
 #include <tcc/Tcc.hpp>
 #include <Parser.hpp>
 #include <Emitter.hpp>
+#include <TensorIo.hpp>
 #include <Timer.hpp>
+#include <MemoryTracker.hpp>
+#include <StepCache.hpp>
 #include <MpiCommunicator.hpp>
 #include <Log.hpp>
 #include <Exception.hpp>
 
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <string>
 #include <sstream>
 
@@ -50,8 +55,10 @@ void Cc4s::addFloatingPointOperations(const Natural<128> ops) {
 }
 
 void Cc4s::runSteps(const bool dry) {
-  auto output(New<MapNode>(SOURCE_LOCATION));
-  output->get("executionEnvironment") = executionEnvironment;
+  // output is appended step by step
+  std::string stagePrefix(dry ? "dry-" : "");
+  IncrementalEmitter emitter(stagePrefix + options->yamlOutFile);
+  emitter.emit("executionEnvironment", executionEnvironment);
 
   Cc4s::dryRun = dry;
   // parse input
@@ -62,9 +69,19 @@ void Cc4s::runSteps(const bool dry) {
 
   // start with empty storage
   storage = New<MapNode>(SOURCE_LOCATION);
+  auto lastUses(getLastUses(steps));
+  auto stepsCount(steps->getSize());
+  // step outputs are only cached in real runs and if requested by any step
+  stepCache = nullptr;
+  for (Natural<> i(0); i < stepsCount && !dry; ++i) {
+    auto step(steps->getMap(i));
+    if (step->isGiven("cache") && step->getValue<bool>("cache")) {
+      stepCache = New<StepCache>(options->cacheDirectory);
+      break;
+    }
+  }
 
-  auto executedSteps(New<MapNode>(SOURCE_LOCATION));
-  output->get("steps") = executedSteps;
+  emitter.emitKey("steps");
 
   Natural<128> totalOperations;
   Time totalTime;
@@ -72,15 +89,18 @@ void Cc4s::runSteps(const bool dry) {
     OperationsCounter totalOperationsCounter(&totalOperations);
     Timer totalTimer(&totalTime);
 
-    for (Natural<> i(0); i < steps->getSize(); ++i) {
+    for (Natural<> i(0); i < stepsCount; ++i) {
       auto step(steps->getMap(i));
       runStep(i, step);
-      executedSteps->get(i) = step;
-      // emit output, overwrite from previous step
-      std::string stagePrefix(dry ? "dry-" : "");
-      Emitter emitter(stagePrefix + options->yamlOutFile);
-      emitter.emit(output);
+      // append executed step to output
+      emitter.emit(std::to_string(i), step, 1);
+      // the emitted step no longer needs to hold its arguments and results
+      step = nullptr;
+      steps->get(i) = nullptr;
+      releaseSymbols(i, lastUses);
     }
+    // finish writing tensors still written in the background
+    TensorIo::awaitWrites();
   }
   Cc4s::dryRun = false;
 
@@ -100,6 +120,10 @@ void Cc4s::runSteps(const bool dry) {
     OUT() << "Memory estimate (per Rank/Total): ";
     OUT() <<  DryMemory::maxTotalSize / GB / getProcessesCount() << " / "
           <<  DryMemory::maxTotalSize / GB << " GB\n";
+    if (DryMemory::maxTotalSize / getProcessesCount() > getMemoryPerRank()) {
+      WARNING() << "Memory estimate exceeds the "
+        << getMemoryPerRank() / GB << " GB available per rank" << std::endl;
+    }
     OUT() << "Operations estimate (per Rank/Total): ";
     OUT() << totalOperations / 1e9 / getProcessesCount() << " / "
           << totalOperations / 1e9 << " GFLOPS" << std::endl;
@@ -115,12 +139,9 @@ void Cc4s::runSteps(const bool dry) {
   statistics->setValue("realtime", totalRealtime.str());
   statistics->setValue("floatingPointOperations", totalOperations);
   statistics->setValue("flops", totalOperations/totalTime.getFractionalSeconds());
-  output->get("statistics") = statistics;
 
-  // emit final stage output
-  std::string stagePrefix( dry ? "dry-" : "" );
-  Emitter emitter(stagePrefix + options->yamlOutFile);
-  emitter.emit(output);
+  // append final statistics to output
+  emitter.emit("statistics", statistics);
 }
 
 void Cc4s::runStep(Natural<> i, const Ptr<MapNode> &step) {
@@ -138,7 +159,15 @@ void Cc4s::runStep(Natural<> i, const Ptr<MapNode> &step) {
   auto inputArguments(step->getMap("in"));
   fetchSymbols(inputArguments);
 
-  Ptr<MapNode> output;
+  // reuse the output of an earlier run if cached and the key matches,
+  // keys are only computed for steps opting into caching
+  auto cached(
+    stepCache && step->isGiven("cache") && step->getValue<bool>("cache")
+  );
+  std::string cacheKey;
+  if (cached) cacheKey = stepCache->getKey(algorithmName, inputArguments);
+  Ptr<MapNode> output(cached ? stepCache->read(cacheKey) : nullptr);
+  auto fromCache(output != nullptr);
   // wait until all processes finished previous work
   Cc4s::world->barrier();
   Natural<128> operations;
@@ -146,7 +175,14 @@ void Cc4s::runStep(Natural<> i, const Ptr<MapNode> &step) {
   {
     OperationsCounter operationsCounter(&operations);
     Timer timer(&time);
-    output = algorithm->run(inputArguments);
+    TimerRegion region(algorithmName);
+    if (!fromCache) output = algorithm->run(inputArguments);
+  }
+  if (cached) {
+    if (!fromCache) stepCache->write(cacheKey, output);
+    if (algorithm->isDeterministic()) {
+      stepCache->setProvenance(cacheKey, output);
+    }
   }
 
   // get output variables, if given
@@ -170,6 +206,8 @@ void Cc4s::runStep(Natural<> i, const Ptr<MapNode> &step) {
   statistics->setValue("realtime", realtime.str());
   statistics->setValue("floatingPointOperations", operations);
   statistics->setValue("flops", operations / time.getFractionalSeconds());
+  statistics->get("regions") = TimerRegion::getStatistics();
+  statistics->get("memory") = MemoryTracker::getStatistics();
   step->get("statistics") = statistics;
   // resources held by the algorithm are released when it goes out of scope
 }
@@ -207,6 +245,38 @@ void Cc4s::storeSymbols(const Ptr<MapNode> &result, const Ptr<MapNode> &variable
   }
 }
 
+std::map<std::string, Natural<>> Cc4s::getLastUses(
+  const Ptr<MapNode> &steps
+) {
+  std::map<std::string, Natural<>> lastUses;
+  for (Natural<> i(0); i < steps->getSize(); ++i) {
+    auto step(steps->getMap(i));
+    for (auto variablesKey: {"in", "out"}) {
+      if (!step->get(variablesKey)) continue;
+      auto variables(step->getMap(variablesKey));
+      for (auto key: variables->getKeys()) {
+        auto symbolNode(variables->get(key)->toPtr<SymbolNode>());
+        // steps are in order, the last reference overwrites earlier ones
+        if (symbolNode) lastUses[symbolNode->value] = i;
+      }
+    }
+  }
+  return lastUses;
+}
+
+void Cc4s::releaseSymbols(
+  const Natural<> i, const std::map<std::string, Natural<>> &lastUses
+) {
+  for (auto &lastUse: lastUses) {
+    if (lastUse.second != i) continue;
+    auto &storedNode(storage->get(lastUse.first));
+    if (storedNode) {
+      LOG() << "releasing " << lastUse.first << " after its last use in step "
+        << (i+1) << std::endl;
+      storedNode = nullptr;
+    }
+  }
+}
 
 void Cc4s::printBanner() {
   OUT() << std::endl
@@ -241,6 +311,7 @@ void Cc4s::printBanner() {
   executionEnvironment->setValue("totalProcesses", world->getProcesses());
   executionEnvironment->setValue("startTime", std::string(ctime (&rawtime)));
   executionEnvironment->setValue("dryRanks", options->dryRanks);
+  executionEnvironment->setValue("memoryPerRank", getMemoryPerRank());
   if (options->dryRanks == 0) {
     OUT() << "DRY RUN ONLY - nothing will be calculated" << std::endl;
   }
@@ -251,32 +322,83 @@ Natural<> Cc4s::getProcessesCount() {
   return options->dryRanks > 0 ? options->dryRanks : Cc4s::world->getProcesses();
 }
 
+Natural<> Cc4s::getMemoryPerRank() {
+  static Natural<> memoryPerRank(0);
+  if (memoryPerRank > 0) return memoryPerRank;
+  memoryPerRank = options->getMemoryPerRank();
+  if (memoryPerRank == 0) {
+    // assuming LINUX
+    std::ifstream memoryStream("/proc/meminfo", std::ios_base::in);
+    std::string field;
+    Natural<> kiloBytes(0);
+    while (memoryStream >> field >> kiloBytes) {
+      if (field == "MemTotal:") break;
+      memoryStream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    memoryPerRank =
+      kiloBytes * 1024 / world->getNodeCommunicator()->getProcesses();
+  }
+  return memoryPerRank;
+}
+
+Natural<> Cc4s::getMemoryShare(const MemoryShare share) {
+  auto memory(getMemoryPerRank());
+  // persistent buffers are taken off all shares
+  memory = reservedMemory < memory ? memory - reservedMemory : 0;
+  switch (share) {
+  case SLICES_MEMORY:
+    return memory / 4;
+  case HISTORY_MEMORY:
+    return memory / 2;
+  case BUFFERS_MEMORY:
+    return memory / 8;
+  }
+  return 0;
+}
+
+void Cc4s::reserveMemory(const Natural<> bytes) {
+  reservedMemory += bytes;
+  if (reservedMemory > getMemoryPerRank()) {
+    auto GB(1024.0*1024.0*1024.0);
+    WARNING() << "Persistent buffers of " << reservedMemory / GB <<
+      " GB exceed the " << getMemoryPerRank() / GB <<
+      " GB available per rank" << std::endl;
+  }
+}
+
+void Cc4s::releaseMemory(const Natural<> bytes) {
+  reservedMemory -= std::min(bytes, reservedMemory);
+}
 
 Ptr<MapNode> Cc4s::getHostList() {
   auto hosts(New<MapNode>(SOURCE_LOCATION));
   if (options->dryRanks == 0) {
-    char ownName[MPI_MAX_PROCESSOR_NAME];
+    // node leaders gather their fixed size processor names at rank 0
+    std::vector<char> ownName(MPI_MAX_PROCESSOR_NAME);
     int nameLength;
-    MPI_Get_processor_name(ownName, &nameLength);
+    MPI_Get_processor_name(ownName.data(), &nameLength);
     ownName[nameLength] = 0;
+    std::vector<char> names;
+    auto leaders(world->getLeaderCommunicator());
+    if (leaders) {
+      if (leaders->getRank() == 0) {
+        names.resize(leaders->getProcesses() * MPI_MAX_PROCESSOR_NAME);
+      }
+      MPI_Gather(
+        ownName.data(), MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+        names.data(), MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+        0, leaders->getComm()
+      );
+    }
+    // and rank 0 gathers the node index of each rank
+    std::vector<Natural<>> ownNode(1, world->getNode()), nodeOfRanks;
+    world->gather(ownNode, nodeOfRanks);
 
-    std::map<std::string,std::vector<int>> ranksOfHosts;
     if (world->getRank() == 0) {
-      // enter hostname/rank
-      ranksOfHosts[ownName].push_back(0);
-      // receive all names but own name from remote ranks
-      for (
-        Natural<> remoteRank(1);
-        remoteRank < world->getProcesses();
-        ++remoteRank
-      ) {
-        char remoteName[MPI_MAX_PROCESSOR_NAME];
-        MPI_Recv(
-          remoteName, MPI_MAX_PROCESSOR_NAME, MPI_BYTE,
-          remoteRank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE
-        );
-        // and enter remote name/rank into map
-        ranksOfHosts[remoteName].push_back(remoteRank);
+      std::map<std::string,std::vector<int>> ranksOfHosts;
+      for (Natural<> rank(0); rank < nodeOfRanks.size(); ++rank) {
+        ranksOfHosts[&names[nodeOfRanks[rank] * MPI_MAX_PROCESSOR_NAME]]
+          .push_back(rank);
       }
       for (auto &ranksOfHost: ranksOfHosts) {
         auto host(New<MapNode>(SOURCE_LOCATION));
@@ -288,12 +410,6 @@ Ptr<MapNode> Cc4s::getHostList() {
         host->get("ranks") = ranks;
         hosts->push_back(host);
       }
-    } else {
-      // send own name
-      MPI_Send(
-        ownName, MPI_MAX_PROCESSOR_NAME, MPI_BYTE,
-        0, 0, MPI_COMM_WORLD
-      );
     }
   } else {
     // TODO: list planned execution environment from options
@@ -301,91 +417,7 @@ Ptr<MapNode> Cc4s::getHostList() {
   return hosts;
 }
 
-bool isDebugged() {
-  // assuming LINUX
-  std::ifstream statusStream("/proc/self/status", std::ios_base::in);
-  std::string line;
-  while (std::getline(statusStream, line)) {
-    std::string pidField("TracerPid:");
-    size_t position(line.find(pidField));
-    if (position != std::string::npos) {
-      std::stringstream pidStream(line.substr(position + pidField.length()));
-      size_t pid; pidStream >> pid;
-      if (pid > 0) {
-        LOG() << "Debugger present" << std::endl;
-      }
-      return pid > 0;
-    }
-  }
-  return false;
-}
-
-
 Ptr<MpiCommunicator> Cc4s::world;
 Ptr<Options> Cc4s::options;
 bool Cc4s::dryRun = false;
-
-
-int main(int argumentCount, char **arguments) {
-  MPI_Init(&argumentCount, &arguments);
-
-  Cc4s::world = New<MpiCommunicator>();
-  Cc4s::options = New<Options>(argumentCount, arguments);
-  if (int errcode = Cc4s::options->parse()) std::exit(errcode);
-
-  Log::setFileName(Cc4s::options->logFile);
-  Log::setRank(Cc4s::world->getRank());
-  Time startTime(Time::getCurrentRealTime());
-  Log::setLogHeaderFunction(
-    [startTime](const SourceLocation &location) {
-      std::stringstream header;
-      header << (Time::getCurrentRealTime() - startTime) << ":";
-      if (location.isValid()) {
-        header << location;
-      }
-      header << ":";
-      return header.str();
-    }
-  );
-  bool isSuccessful(true);
-
-  Cc4s cc4s;
-  if (isDebugged()) {
-    // run without try-catch in debugger to allow tracing throwing code
-    cc4s.run();
-  } else {
-    // without debugger: catch and write list of causes
-    try {
-      cc4s.run();
-    } catch (Ptr<Exception> cause) {
-      isSuccessful = false;
-      auto sourceLocation(cause->getSourceLocation());
-      if (!sourceLocation.isValid()) sourceLocation = SOURCE_LOCATION;
-      ERROR_LOCATION(sourceLocation) << cause->what() << std::endl;
-      cause = cause->getCause();
-      while (cause) {
-        if (cause->getSourceLocation().isValid()) {
-          sourceLocation = cause->getSourceLocation();
-        }
-        ERROR_LOCATION(sourceLocation) <<
-          "Caused by: " << cause->what() << std::endl;
-        cause = cause->getCause();
-      }
-    } catch (std::exception &cause) {
-      isSuccessful = false;
-      OUT() << "unhandled exception encountered (std::exception):" << std::endl;
-      OUT() << cause.what() << std::endl;
-    } catch (const char *message) {
-      isSuccessful = false;
-      OUT() << "unhandled exception encountered (const char *):" << std::endl;
-      OUT() << message << std::endl;
-    } catch (...) {
-      isSuccessful = false;
-      OUT() << "unhandled exception encountered (...)." << std::endl;
-    }
-  }
-
-  MPI_Finalize();
-  return isSuccessful ? 0 : 1;
-}
-
+Natural<> Cc4s::reservedMemory = 0;
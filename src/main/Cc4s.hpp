@@ -22,9 +22,14 @@
 #include <Options.hpp>
 #include <Node.hpp>
 
+#include <map>
+#include <string>
+
 int main(int argumentCount, char **arguments);
 
 namespace cc4s {
+  class StepCache;
+
   class Cc4s {
   public:
     void run();
@@ -37,16 +42,63 @@ namespace cc4s {
     static Natural<128> getFloatingPointOperations();
     static void addFloatingPointOperations(const Natural<128> ops);
     static Natural<> getProcessesCount();
+    /**
+     * \brief Memory in bytes available to each rank, either given by
+     * the memory-per-rank option or the physical memory of each node
+     * divided among its ranks.
+     **/
+    static Natural<> getMemoryPerRank();
+
+    /**
+     * \brief Consumers of the memory budget of each rank. After taking
+     * off the memory reserved by persistent buffers, the budget is split
+     * into fixed shares: a quarter for sliced or batched intermediates,
+     * such as the particle-particle ladder, half for the DIIS history and
+     * an eighth for read and write buffers. The remaining eighth is left
+     * for amplitudes, residua and intermediates outside of any share.
+     **/
+    enum MemoryShare {
+      SLICES_MEMORY, HISTORY_MEMORY, BUFFERS_MEMORY
+    };
+    /**
+     * \brief Memory in bytes of the given share of the budget of each rank.
+     **/
+    static Natural<> getMemoryShare(const MemoryShare share);
+    /**
+     * \brief Reserves the given bytes per rank for buffers kept beyond
+     * a single contraction, such as the dressed Coulomb vertex of Ccsd.
+     * Reserved memory is taken off all shares until it is released.
+     **/
+    static void reserveMemory(const Natural<> bytes);
+    static void releaseMemory(const Natural<> bytes);
 
   protected:
+    static Natural<> reservedMemory;
+
     void runSteps(const bool dry = false);
     void runStep(const Natural<> i, const Ptr<MapNode> &step);
     void fetchSymbols(const Ptr<MapNode> &arguments);
     void storeSymbols(const Ptr<MapNode> &result,const Ptr<MapNode> &variables);
+    /**
+     * \brief Returns the index of the last step referring to each symbol
+     * in its input or output variables.
+     **/
+    std::map<std::string, Natural<>> getLastUses(const Ptr<MapNode> &steps);
+    /**
+     * \brief Releases all stored symbols whose last use is the given step,
+     * freeing their tensors unless referenced elsewhere.
+     **/
+    void releaseSymbols(
+      const Natural<> i, const std::map<std::string, Natural<>> &lastUses
+    );
     void printBanner();
     Ptr<MapNode> getHostList();
 
     Ptr<MapNode> executionEnvironment, storage;
+    /**
+     * \brief Cache of step outputs, only present if any step is cached.
+     **/
+    Ptr<StepCache> stepCache;
   };
 
   class OperationsCounter {
@@ -21,6 +21,9 @@
 #include <SharedPointer.hpp>
 
 #include <string>
+#include <sstream>
+#include <fstream>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
 namespace cc4s {
@@ -32,9 +35,16 @@ namespace cc4s {
     Emitter(const std::string &fileName): yamlEmitter(stream) {
       if (Cc4s::world->getRank() == 0) stream.open(fileName);
     }
+    /**
+     * \brief Creates an emitter writing to the given stream on all ranks.
+     **/
+    Emitter(std::ostream &targetStream): yamlEmitter(targetStream) {
+    }
     void emit(const Ptr<Node> &node) {
       auto mapNode(node->toPtr<MapNode>());
       if (mapNode) return emitMap(mapNode);
+      auto arrayNode(node->toPtr<ArrayNodeBase>());
+      if (arrayNode) return emitArray(arrayNode);
       auto symbolNode(node->toPtr<SymbolNode>());
       if (symbolNode) {
         emitSymbol(symbolNode);
@@ -67,9 +77,81 @@ namespace cc4s {
       yamlEmitter << YAML::EndMap;
     }
 
+    void emitArray(Ptr<ArrayNodeBase> arrayNode) {
+      yamlEmitter << YAML::Flow << YAML::BeginSeq;
+      for (Natural<> i(0); i < arrayNode->getSize(); ++i) {
+        if (arrayNode->hasAtomicElements()) {
+          yamlEmitter << arrayNode->getElementString(i);
+        } else {
+          // e.g. tuples of tuple arrays
+          emit(arrayNode->getElement(i));
+        }
+      }
+      yamlEmitter << YAML::EndSeq;
+    }
+
     std::ofstream stream;
     YAML::Emitter yamlEmitter;
   };
+
+  /**
+   * \brief Emitter appending entries to a yaml map file one at a time,
+   * such that the file is valid yaml after each append and earlier
+   * entries are not emitted again. Only rank 0 writes.
+   */
+  class IncrementalEmitter {
+  public:
+    IncrementalEmitter(const std::string &fileName): buffer(BUFFER_SIZE) {
+      if (Cc4s::world->getRank() == 0) {
+        stream.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+        stream.open(fileName);
+      }
+    }
+
+    /**
+     * \brief Appends the given key and node as entry of a map nested
+     * at the given level.
+     **/
+    void emit(
+      const std::string &key, const Ptr<Node> &node, const Natural<> level = 0
+    ) {
+      if (Cc4s::world->getRank() != 0) return;
+      auto entry(New<MapNode>(node->sourceLocation));
+      entry->get(key) = node;
+      std::stringstream entryStream;
+      {
+        Emitter emitter(entryStream);
+        emitter.emit(entry);
+      }
+      // indent each line of the entry according to its level
+      std::string indentation(2*level, ' ');
+      std::string line;
+      while (std::getline(entryStream, line)) {
+        stream << indentation << line << '\n';
+      }
+      stream.flush();
+    }
+
+    /**
+     * \brief Appends the given key of a map nested at the given level,
+     * whose entries follow in subsequent emits at the next level.
+     **/
+    void emitKey(const std::string &key, const Natural<> level = 0) {
+      if (Cc4s::world->getRank() != 0) return;
+      std::stringstream keyStream;
+      {
+        YAML::Emitter yamlEmitter(keyStream);
+        yamlEmitter << key;
+      }
+      stream << std::string(2*level, ' ') << keyStream.str() << ":\n";
+      stream.flush();
+    }
+
+  protected:
+    static constexpr Natural<> BUFFER_SIZE = 1024*1024;
+    std::vector<char> buffer;
+    std::ofstream stream;
+  };
 }
 
 #endif
@@ -15,16 +15,26 @@
 
 #include <Log.hpp>
 #include <Complex.hpp>
+#include <Exception.hpp>
 
 #include <sstream>
 #include <string>
+#include <chrono>
+#include <exception>
+#include <cstdlib>
 
 using namespace cc4s;
 
 int Log::rank(-1);
 std::string Log::fileName("cc4s.log");
-std::ofstream Log::logStream;
+AsyncFileBuffer Log::logBuffer;
+std::ostream Log::logStream(&Log::logBuffer);
+// errors and warnings also enter the log and are written synchronously
+TeeBuffer Log::errorBuffer(std::cerr, Log::logStream);
+std::ostream Log::errorStream(&Log::errorBuffer);
 std::ofstream Log::nullStream;
+std::map<std::string, int> Log::verbosities;
+int Log::defaultVerbosity(1);
 
 Log::HeaderFunction Log::outHeaderFunction(
   [](const SourceLocation &){ return ""; }
@@ -51,8 +61,13 @@ Log::HeaderFunction Log::logHeaderFunction(
 void Log::setRank(int const rank_) {
   rank = rank_;
   if (rank == 0) {
-    logStream.open(
-      fileName.c_str(), std::ofstream::out | std::ofstream::trunc
+    logBuffer.open(fileName);
+    // write pending log entries if cc4s terminates abnormally
+    std::set_terminate(
+      [](){
+        Log::close();
+        std::abort();
+      }
     );
   }
   // keep a nul stream should the output be masked, e.g. on non-root ranks
@@ -71,3 +86,145 @@ std::string Log::getFileName() {
   return fileName;
 }
 
+void Log::close() {
+  logStream.flush();
+  logBuffer.close();
+}
+
+void Log::flush() {
+  logStream.flush();
+  logBuffer.flushFile();
+}
+
+void Log::setVerbosity(const std::string &verbosity) {
+  std::stringstream stream(verbosity);
+  std::string entry;
+  while (std::getline(stream, entry, ',')) {
+    auto equalPosition(entry.find('='));
+    auto levelString(
+      equalPosition == std::string::npos ?
+        entry : entry.substr(equalPosition+1)
+    );
+    std::stringstream levelStream(levelString);
+    int level;
+    levelStream >> level;
+    if (levelStream.fail() || !(levelStream >> std::ws).eof()) {
+      THROW(
+        "Invalid log verbosity entry '" + entry + "' in '" + verbosity +
+        "', expecting level or category=level, e.g. 1,tcc=2"
+      );
+    }
+    if (equalPosition == std::string::npos) {
+      defaultVerbosity = level;
+    } else {
+      verbosities[entry.substr(0, equalPosition)] = level;
+    }
+  }
+}
+
+
+TeeBuffer::TeeBuffer(
+  std::ostream &console_, std::ostream &log_
+): console(console_), log(log_) {
+}
+
+TeeBuffer::int_type TeeBuffer::overflow(int_type c) {
+  if (c == traits_type::eof()) return traits_type::not_eof(c);
+  char character(traits_type::to_char_type(c));
+  xsputn(&character, 1);
+  return c;
+}
+
+std::streamsize TeeBuffer::xsputn(const char *data, std::streamsize size) {
+  console.write(data, size);
+  log.write(data, size);
+  return size;
+}
+
+int TeeBuffer::sync() {
+  console.flush();
+  Log::flush();
+  return 0;
+}
+
+
+AsyncFileBuffer::AsyncFileBuffer(
+  const size_t capacity
+): ring(capacity), head(0), tail(0), flushed(0), running(false) {
+}
+
+AsyncFileBuffer::~AsyncFileBuffer() {
+  close();
+}
+
+void AsyncFileBuffer::open(const std::string &fileName) {
+  close();
+  file.open(fileName.c_str(), std::ofstream::out | std::ofstream::trunc);
+  running = true;
+  writer = std::thread(&AsyncFileBuffer::writeFile, this);
+}
+
+void AsyncFileBuffer::flushFile() {
+  if (!writer.joinable()) return;
+  auto h(head.load(std::memory_order_acquire));
+  while (flushed.load(std::memory_order_acquire) < h) {
+    std::this_thread::yield();
+  }
+}
+
+void AsyncFileBuffer::close() {
+  if (!writer.joinable()) return;
+  // the writer finishes all entered output before stopping
+  running = false;
+  writer.join();
+  file.close();
+}
+
+AsyncFileBuffer::int_type AsyncFileBuffer::overflow(int_type c) {
+  if (c == traits_type::eof()) return traits_type::not_eof(c);
+  char character(traits_type::to_char_type(c));
+  xsputn(&character, 1);
+  return c;
+}
+
+std::streamsize AsyncFileBuffer::xsputn(
+  const char *data, std::streamsize size
+) {
+  // output is discarded if the buffer has not been opened
+  if (!writer.joinable()) return size;
+  auto h(head.load(std::memory_order_relaxed));
+  for (std::streamsize i(0); i < size; ++i, ++h) {
+    // wait for the writer if the ring is full
+    while (h - tail.load(std::memory_order_acquire) == ring.size()) {
+      head.store(h, std::memory_order_release);
+      std::this_thread::yield();
+    }
+    ring[h % ring.size()] = data[i];
+  }
+  head.store(h, std::memory_order_release);
+  return size;
+}
+
+void AsyncFileBuffer::writeFile() {
+  while (true) {
+    // read running before head to write all output entered before closing
+    bool stopping(!running.load(std::memory_order_acquire));
+    auto h(head.load(std::memory_order_acquire));
+    auto t(tail.load(std::memory_order_relaxed));
+    if (h == t) {
+      if (stopping) break;
+      if (flushed.load(std::memory_order_relaxed) != t) {
+        file.flush();
+        flushed.store(t, std::memory_order_release);
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+    // write the contiguous part of the pending output
+    auto begin(t % ring.size());
+    auto size(std::min(h - t, ring.size() - begin));
+    file.write(ring.data() + begin, size);
+    tail.store(t + size, std::memory_order_release);
+  }
+  file.flush();
+}
@@ -24,8 +24,63 @@
 #include <streambuf>
 #include <fstream>
 #include <functional>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <thread>
 
 namespace cc4s {
+  /**
+   * \brief Stream buffer collecting output in a lock-free ring buffer,
+   * from where a background thread writes it to a file. Output is thus
+   * not delayed by the file system. Only one thread may write at a time.
+   */
+  class AsyncFileBuffer: public std::streambuf {
+  public:
+    AsyncFileBuffer(const size_t capacity = 1024*1024);
+    ~AsyncFileBuffer();
+    void open(const std::string &fileName);
+    /**
+     * \brief Waits until the background thread has written all output
+     * and stops it.
+     **/
+    void close();
+    /**
+     * \brief Waits until the background thread has written and flushed
+     * all output entered so far.
+     **/
+    void flushFile();
+
+  protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char *data, std::streamsize size) override;
+    void writeFile();
+
+    std::vector<char> ring;
+    // total number of bytes entered, written and flushed, respectively
+    std::atomic<size_t> head, tail, flushed;
+    std::atomic<bool> running;
+    std::thread writer;
+    std::ofstream file;
+  };
+
+  /**
+   * \brief Stream buffer passing output to a console stream and to the log
+   * stream. Flushing, e.g. by std::endl, waits until the log file is
+   * written, such that errors and warnings are not lost if cc4s aborts.
+   */
+  class TeeBuffer: public std::streambuf {
+  public:
+    TeeBuffer(std::ostream &console, std::ostream &log);
+
+  protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char *data, std::streamsize size) override;
+    int sync() override;
+
+    std::ostream &console, &log;
+  };
+
   /**
    * \brief Class with static members offering control over logging.
    * Log entries are created with the macro LOG.
@@ -41,7 +96,7 @@ namespace cc4s {
       else return nullStream;
     }
     static std::ostream &getErrorStream() {
-      if (rank == 0) return std::cerr;
+      if (rank == 0) return errorStream;
       else return nullStream;
     }
     static std::ostream &getWarningStream() {
@@ -50,10 +105,39 @@ namespace cc4s {
     }
     static void setFileName(const std::string &fileName);
     static std::string getFileName();
-    static std::ofstream &getLogStream() {
+    static std::ostream &getLogStream() {
       if (rank == 0) return logStream;
       else return nullStream;
     }
+    /**
+     * \brief Writes all pending log entries and closes the log file.
+     **/
+    static void close();
+    /**
+     * \brief Waits until all pending log entries are written to the
+     * log file.
+     **/
+    static void flush();
+
+    /**
+     * \brief Sets the verbosity levels from a comma separated list
+     * of entries category=level. An entry with only a level sets the
+     * level of all other categories, which is 1 by default.
+     * Throws if an entry cannot be parsed.
+     **/
+    static void setVerbosity(const std::string &verbosity);
+    /**
+     * \brief Whether log entries of the given category and level are
+     * written. Only rank 0 writes log entries.
+     **/
+    static bool isLogged(const std::string &category, const int level) {
+      if (rank != 0) return false;
+      auto categoryVerbosity(verbosities.find(category));
+      return level <= (
+        categoryVerbosity != verbosities.end() ?
+          categoryVerbosity->second : defaultVerbosity
+      );
+    }
     static void setOutHeaderFunction(const HeaderFunction &f) {
       outHeaderFunction = f;
     }
@@ -82,12 +166,27 @@ namespace cc4s {
   protected:
     static int rank;
     static std::string fileName;
-    static std::ofstream logStream;
+    static AsyncFileBuffer logBuffer;
+    static std::ostream logStream;
+    static TeeBuffer errorBuffer;
+    static std::ostream errorStream;
     static std::ofstream nullStream;
+    static std::map<std::string, int> verbosities;
+    static int defaultVerbosity;
     static HeaderFunction
       outHeaderFunction, errorHeaderFunction, warningHeaderFunction,
       logHeaderFunction;
   };
+
+  /**
+   * \brief Turns a logging expression into void such that it can be
+   * skipped conditionally.
+   */
+  class LogVoidifier {
+  public:
+    void operator &(std::ostream &) {
+    }
+  };
 }
 
 /**
@@ -106,10 +205,18 @@ namespace cc4s {
   (Log::getErrorStream() << Log::getWarningHeaderFunction()(SOURCE_LOCATION))
 #define WARNING_LOCATION(LOCATION) \
   (Log::getErrorStream() << Log::getWarningHeaderFunction()(LOCATION))
-#define LOG() \
-  (Log::getLogStream() << Log::getLogHeaderFunction()(SOURCE_LOCATION))
-#define LOG_LOCATION(LOCATION) \
-  (Log::getLogStream() << Log::getLogHeaderFunction()(LOCATION))
+#define LOG() LOG_CATEGORY("", 1)
+#define LOG_LOCATION(LOCATION) LOG_CATEGORY_LOCATION("", 1, LOCATION)
+
+/**
+ * \brief Provides the log stream for entries of the given category and
+ * verbosity level. Nothing is evaluated if they are not logged.
+ */
+#define LOG_CATEGORY(CATEGORY, LEVEL) \
+  LOG_CATEGORY_LOCATION(CATEGORY, LEVEL, SOURCE_LOCATION)
+#define LOG_CATEGORY_LOCATION(CATEGORY, LEVEL, LOCATION) \
+  !Log::isLogged(CATEGORY, LEVEL) ? (void)0 : LogVoidifier() & \
+    (Log::getLogStream() << Log::getLogHeaderFunction()(LOCATION))
 
 #endif
 
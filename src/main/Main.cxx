@@ -0,0 +1,113 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <Cc4s.hpp>
+#include <Time.hpp>
+#include <MpiCommunicator.hpp>
+#include <Log.hpp>
+#include <Exception.hpp>
+
+#include <fstream>
+#include <string>
+#include <sstream>
+
+using namespace cc4s;
+
+bool isDebugged() {
+  // assuming LINUX
+  std::ifstream statusStream("/proc/self/status", std::ios_base::in);
+  std::string line;
+  while (std::getline(statusStream, line)) {
+    std::string pidField("TracerPid:");
+    size_t position(line.find(pidField));
+    if (position != std::string::npos) {
+      std::stringstream pidStream(line.substr(position + pidField.length()));
+      size_t pid; pidStream >> pid;
+      if (pid > 0) {
+        LOG() << "Debugger present" << std::endl;
+      }
+      return pid > 0;
+    }
+  }
+  return false;
+}
+
+int main(int argumentCount, char **arguments) {
+  MPI_Init(&argumentCount, &arguments);
+
+  Cc4s::world = New<MpiCommunicator>();
+  Cc4s::world->discoverNodes();
+  Cc4s::options = New<Options>(argumentCount, arguments);
+  if (int errcode = Cc4s::options->parse()) std::exit(errcode);
+
+  Log::setFileName(Cc4s::options->logFile);
+  Log::setRank(Cc4s::world->getRank());
+  Time startTime(Time::getCurrentRealTime());
+  Log::setLogHeaderFunction(
+    [startTime](const SourceLocation &location) {
+      std::stringstream header;
+      header << (Time::getCurrentRealTime() - startTime) << ":";
+      if (location.isValid()) {
+        header << location;
+      }
+      header << ":";
+      return header.str();
+    }
+  );
+  bool isSuccessful(true);
+
+  Cc4s cc4s;
+  if (isDebugged()) {
+    // run without try-catch in debugger to allow tracing throwing code
+    Log::setVerbosity(Cc4s::options->logVerbosity);
+    cc4s.run();
+  } else {
+    // without debugger: catch and write list of causes
+    try {
+      Log::setVerbosity(Cc4s::options->logVerbosity);
+      cc4s.run();
+    } catch (Ptr<Exception> cause) {
+      isSuccessful = false;
+      auto sourceLocation(cause->getSourceLocation());
+      if (!sourceLocation.isValid()) sourceLocation = SOURCE_LOCATION;
+      ERROR_LOCATION(sourceLocation) << cause->what() << std::endl;
+      cause = cause->getCause();
+      while (cause) {
+        if (cause->getSourceLocation().isValid()) {
+          sourceLocation = cause->getSourceLocation();
+        }
+        ERROR_LOCATION(sourceLocation) <<
+          "Caused by: " << cause->what() << std::endl;
+        cause = cause->getCause();
+      }
+    } catch (std::exception &cause) {
+      isSuccessful = false;
+      OUT() << "unhandled exception encountered (std::exception):" << std::endl;
+      OUT() << cause.what() << std::endl;
+    } catch (const char *message) {
+      isSuccessful = false;
+      OUT() << "unhandled exception encountered (const char *):" << std::endl;
+      OUT() << message << std::endl;
+    } catch (...) {
+      isSuccessful = false;
+      OUT() << "unhandled exception encountered (...)." << std::endl;
+    }
+  }
+
+  Log::close();
+  MPI_Finalize();
+  return isSuccessful ? 0 : 1;
+}
+
@@ -0,0 +1,129 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <MemoryTracker.hpp>
+#include <Cc4s.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+using namespace cc4s;
+
+std::map<const void *, MemoryTracker::Allocation> MemoryTracker::allocations;
+std::vector<MemoryTracker::Allocation> MemoryTracker::allocationsAtPeak;
+Natural<> MemoryTracker::currentBytes(0), MemoryTracker::peakBytes(0);
+
+void MemoryTracker::allocate(
+  const void *tensor, const std::string &name, const Natural<> bytes
+) {
+  allocations[tensor] = Allocation(name, bytes);
+  currentBytes += bytes;
+  if (currentBytes > peakBytes) {
+    peakBytes = currentBytes;
+    allocationsAtPeak.clear();
+    for (auto &allocation: allocations) {
+      allocationsAtPeak.push_back(allocation.second);
+    }
+  }
+}
+
+void MemoryTracker::free(const void *tensor) {
+  auto allocation(allocations.find(tensor));
+  if (allocation == allocations.end()) return;
+  currentBytes -= allocation->second.second;
+  allocations.erase(allocation);
+}
+
+Natural<> MemoryTracker::getResidentSetSize(const std::string &field) {
+  // assuming LINUX
+  std::ifstream statusStream("/proc/self/status", std::ios_base::in);
+  std::string line;
+  while (std::getline(statusStream, line)) {
+    if (line.compare(0, field.size()+1, field + ":") == 0) {
+      std::stringstream sizeStream(line.substr(field.size()+1));
+      Natural<> kiloBytes(0);
+      sizeStream >> kiloBytes;
+      return kiloBytes * 1024;
+    }
+  }
+  return 0;
+}
+
+Ptr<MapNode> MemoryTracker::getStatistics() {
+  auto world(Cc4s::world);
+  auto comm(world->getComm());
+  // local peak, resident set size and its high water mark
+  std::vector<Real<>> local(3), maxs(3), sums(3);
+  local[0] = peakBytes;
+  local[1] = getResidentSetSize("VmRSS");
+  local[2] = getResidentSetSize("VmHWM");
+  MPI_Allreduce(local.data(), maxs.data(), 3, MPI_DOUBLE, MPI_MAX, comm);
+  MPI_Allreduce(local.data(), sums.data(), 3, MPI_DOUBLE, MPI_SUM, comm);
+
+  // find rank with the largest peak and broadcast its tensors at the peak
+  struct { double value; int rank; } localPeak, maxPeak;
+  localPeak.value = peakBytes;
+  localPeak.rank = world->getRank();
+  MPI_Allreduce(&localPeak, &maxPeak, 1, MPI_DOUBLE_INT, MPI_MAXLOC, comm);
+  std::sort(
+    allocationsAtPeak.begin(), allocationsAtPeak.end(),
+    [](const Allocation &a, const Allocation &b) {
+      return a.second > b.second;
+    }
+  );
+  std::stringstream tensorsStream;
+  for (auto &allocation: allocationsAtPeak) {
+    tensorsStream << allocation.second << " " << allocation.first << "\n";
+  }
+  std::string tensors(tensorsStream.str());
+  world->broadcast(tensors, maxPeak.rank);
+
+  auto processes(world->getProcesses());
+  auto statistics(New<MapNode>(SOURCE_LOCATION));
+  statistics->setValue("maxTensorBytes", static_cast<Natural<>>(maxs[0]));
+  statistics->setValue(
+    "averageTensorBytes", static_cast<Natural<>>(sums[0] / processes)
+  );
+  statistics->setValue("maxResidentBytes", static_cast<Natural<>>(maxs[1]));
+  statistics->setValue(
+    "averageResidentBytes", static_cast<Natural<>>(sums[1] / processes)
+  );
+  statistics->setValue(
+    "maxResidentBytesHighWaterMark", static_cast<Natural<>>(maxs[2])
+  );
+  auto tensorsAtPeak(New<MapNode>(SOURCE_LOCATION));
+  std::stringstream stream(tensors);
+  Natural<> bytes;
+  std::string name;
+  while (stream >> bytes && std::getline(stream, name)) {
+    auto tensor(New<MapNode>(SOURCE_LOCATION));
+    tensor->setValue("name", name.substr(1));
+    tensor->setValue("bytes", bytes);
+    tensorsAtPeak->push_back(tensor);
+  }
+  statistics->get("tensorsAtPeak") = tensorsAtPeak;
+  statistics->setValue("peakRank", static_cast<Natural<>>(maxPeak.rank));
+
+  // start over with the currently allocated tensors
+  peakBytes = currentBytes;
+  allocationsAtPeak.clear();
+  for (auto &allocation: allocations) {
+    allocationsAtPeak.push_back(allocation.second);
+  }
+  return statistics;
+}
+
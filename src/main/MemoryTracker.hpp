@@ -0,0 +1,70 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef MEMORY_TRACKER_DEFINED
+#define MEMORY_TRACKER_DEFINED
+
+#include <Integer.hpp>
+#include <Node.hpp>
+#include <SharedPointer.hpp>
+
+#include <string>
+#include <map>
+#include <vector>
+#include <utility>
+
+namespace cc4s {
+  /**
+   * \brief Tracks the bytes of the allocated machine tensors on this rank,
+   * their peak since the last report and the tensors alive at the peak.
+   * In contrast to DryMemory, which estimates the memory of a dry run,
+   * actual allocations are tracked.
+   */
+  class MemoryTracker {
+  public:
+    /**
+     * \brief Enters the given number of local bytes of the tensor
+     * identified by the given address.
+     */
+    static void allocate(
+      const void *tensor, const std::string &name, const Natural<> bytes
+    );
+    static void free(const void *tensor);
+
+    /**
+     * \brief Reduces the peak of the tracked bytes since the last call
+     * as well as the current process resident set size over all ranks.
+     * The tensors alive at the peak are listed for the rank with the
+     * largest peak. Must be called collectively.
+     */
+    static Ptr<MapNode> getStatistics();
+
+    /**
+     * \brief Resident set size and its high water mark of this process
+     * in bytes, as given in /proc/self/status.
+     */
+    static Natural<> getResidentSetSize(const std::string &field = "VmRSS");
+
+  protected:
+    typedef std::pair<std::string, Natural<>> Allocation;
+    static std::map<const void *, Allocation> allocations;
+    static std::vector<Allocation> allocationsAtPeak;
+    static Natural<> currentBytes, peakBytes;
+  };
+}
+
+#endif
+
@@ -19,8 +19,10 @@
 #include <Integer.hpp>
 #include <Complex.hpp>
 #include <Vector.hpp>
+#include <SharedPointer.hpp>
 
 #include <vector>
+#include <string>
 #include "mpi.h"
 
 namespace cc4s {
@@ -33,13 +35,13 @@ namespace cc4s {
   public:
     MpiCommunicator(
       MPI_Comm comm_ = MPI_COMM_WORLD
-    ): rank(0), processes(0), comm(comm_) {
+    ): rank(0), processes(0), comm(comm_), node(0), nodes(1) {
       MPI_Comm_rank(comm, reinterpret_cast<int *>(&rank));
       MPI_Comm_size(comm, reinterpret_cast<int *>(&processes));
     }
     MpiCommunicator(
       Natural<> rank_, Natural<> processes_, MPI_Comm comm_ = MPI_COMM_WORLD
-    ): rank(rank_), processes(processes_), comm(comm_) {
+    ): rank(rank_), processes(processes_), comm(comm_), node(0), nodes(1) {
     }
     ~MpiCommunicator() {
     }
@@ -57,6 +59,23 @@ namespace cc4s {
       );
     }
 
+    /**
+     * \brief Sums the src vectors of all ranks elementwise into the
+     * dst vector at the given root rank, by default rank 0.
+     **/
+    template <typename F>
+    void reduce(
+      const std::vector<F> &src, std::vector<F> &dst, Natural<> rootRank = 0
+    ) {
+      dst.resize(src.size());
+      MPI_Reduce(
+        src.data(), dst.data(),
+        src.size() * MpiTypeTraits<F>::elementCount(),
+        MpiTypeTraits<F>::elementType(),
+        MPI_SUM, rootRank, comm
+      );
+    }
+
     template <typename F>
     void allReduce(const F &src, F &dst) {
       MPI_Allreduce(
@@ -66,6 +85,21 @@ namespace cc4s {
       );
     }
 
+    /**
+     * \brief Sums the src vectors of all ranks elementwise and
+     * distributes the result to all ranks in the dst vector.
+     **/
+    template <typename F>
+    void allReduce(const std::vector<F> &src, std::vector<F> &dst) {
+      dst.resize(src.size());
+      MPI_Allreduce(
+        src.data(), dst.data(),
+        src.size() * MpiTypeTraits<F>::elementCount(),
+        MpiTypeTraits<F>::elementType(),
+        MPI_SUM, comm
+      );
+    }
+
     /**
      * \Brief Gathers the src vectors of all ranks together to the dst
      * vector at the given root rank, by default rank 0.
@@ -118,6 +152,17 @@ namespace cc4s {
       );
     }
 
+    /**
+     * \brief Broadcasts the given string from the given root rank,
+     * by default rank 0, to all ranks.
+     **/
+    void broadcast(std::string &data, Natural<> rootRank = 0) {
+      std::vector<Natural<>> size(1, data.size());
+      broadcast(size, rootRank);
+      data.resize(size[0]);
+      MPI_Bcast(&data[0], size[0], MPI_BYTE, rootRank, comm);
+    }
+
     Natural<> getRank() const {
       return rank;
     }
@@ -128,9 +173,68 @@ namespace cc4s {
       return comm;
     }
 
+    /**
+     * \brief Discovers the nodes, i.e. the shared memory domains, of the
+     * ranks in this communicator and creates the node and the leader
+     * communicators. Must be called collectively by all ranks.
+     **/
+    void discoverNodes() {
+      MPI_Comm nodeComm;
+      MPI_Comm_split_type(
+        comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &nodeComm
+      );
+      nodeCommunicator = New<MpiCommunicator>(nodeComm);
+      // the local rank 0 of each node is its leader
+      MPI_Comm leaderComm;
+      MPI_Comm_split(
+        comm, nodeCommunicator->getRank() == 0 ? 0 : MPI_UNDEFINED, rank,
+        &leaderComm
+      );
+      if (leaderComm != MPI_COMM_NULL) {
+        leaderCommunicator = New<MpiCommunicator>(leaderComm);
+      }
+      // leaders enumerate the nodes and tell the other ranks of their node
+      std::vector<Natural<>> nodeInfo(2);
+      if (leaderCommunicator) {
+        nodeInfo[0] = leaderCommunicator->getRank();
+        nodeInfo[1] = leaderCommunicator->getProcesses();
+      }
+      nodeCommunicator->broadcast(nodeInfo);
+      node = nodeInfo[0];
+      nodes = nodeInfo[1];
+    }
+
+    /**
+     * \brief Communicator of all ranks on the same node as this rank.
+     * Available after discoverNodes.
+     **/
+    Ptr<MpiCommunicator> getNodeCommunicator() const {
+      return nodeCommunicator;
+    }
+    /**
+     * \brief Communicator of the ranks with local rank 0 on their node.
+     * It is nullptr on all other ranks. Available after discoverNodes.
+     **/
+    Ptr<MpiCommunicator> getLeaderCommunicator() const {
+      return leaderCommunicator;
+    }
+    /**
+     * \brief Index of the node of this rank and number of nodes.
+     * Available after discoverNodes.
+     **/
+    Natural<> getNode() const {
+      return node;
+    }
+    Natural<> getNodes() const {
+      return nodes;
+    }
+
   protected:
     Natural<> rank, processes;
     MPI_Comm comm;
+    // node topology, the communicators are freed by MPI_Finalize
+    Ptr<MpiCommunicator> nodeCommunicator, leaderCommunicator;
+    Natural<> node, nodes;
   };
 
 
@@ -28,10 +28,14 @@
 #include <vector>
 #include <sstream>
 #include <iomanip>
+#include <type_traits>
+#include <limits>
+#include <cmath>
 
 namespace cc4s {
   // forward declarations
   class MapNode;
+  class ArrayNodeBase;
   class SymbolNode;
   template <typename AtomicType> class AtomicNode;
   template <typename PointedType> class PointerNode;
@@ -97,9 +101,126 @@ namespace cc4s {
     }
   };
 
+  /**
+   * \brief Base class of dense arrays of atomic values, independent
+   * of the type of the values.
+   **/
+  class ArrayNodeBase: public Node {
+  public:
+    ArrayNodeBase(
+      const SourceLocation &sourceLocation_
+    ): Node(sourceLocation_) {
+    }
+    bool isAtomic() override {
+      return false;
+    }
+    std::string toString() override {
+      return "[...]";
+    }
+    virtual Natural<> getSize() const = 0;
+    /**
+     * \brief String representation of the element at the given index.
+     **/
+    virtual std::string getElementString(const Natural<> index) const = 0;
+    /**
+     * \brief Node containing the element at the given index.
+     **/
+    virtual Ptr<Node> getElement(const Natural<> index) const = 0;
+    /**
+     * \brief Whether the elements are atomic values rather than
+     * sequences themselves.
+     **/
+    virtual bool hasAtomicElements() const {
+      return true;
+    }
+  };
+
+  /**
+   * \brief Dense array of atomic values with constant time indexed access,
+   * intended for long lists of numbers such as orbital energies.
+   * In contrast to a MapNode used as sequence, no string key is stored
+   * per element. Array nodes are read from and emitted as flow-style
+   * sequences, e.g. [1, 2, 3].
+   **/
+  template <typename AtomicType>
+  class ArrayNode: public ArrayNodeBase {
+  public:
+    ArrayNode(
+      const SourceLocation &sourceLocation_
+    ): ArrayNodeBase(sourceLocation_) {
+    }
+    ArrayNode(
+      const std::vector<AtomicType> &values_,
+      const SourceLocation &sourceLocation_
+    ): ArrayNodeBase(sourceLocation_), values(values_) {
+    }
+    Natural<> getSize() const override {
+      return values.size();
+    }
+    std::string getElementString(const Natural<> index) const override {
+      std::stringstream stream;
+      stream << std::setprecision(17) << values[index];
+      return stream.str();
+    }
+    Ptr<Node> getElement(const Natural<> index) const override {
+      return New<AtomicNode<AtomicType>>(values[index], sourceLocation);
+    }
+    AtomicType &operator[](const Natural<> index) {
+      return values[index];
+    }
+    void push_back(const AtomicType &value) {
+      values.push_back(value);
+    }
+
+    std::vector<AtomicType> values;
+  };
+
+  /**
+   * \brief Dense array of equally long tuples of atomic values, stored
+   * contiguously, e.g. the index tuples of the non-zero blocks of
+   * block-sparse tensors. Tuple arrays are read from and emitted as
+   * sequences of flow-style sequences of equal length, e.g. [[0, 1], [1, 0]].
+   **/
+  template <typename AtomicType>
+  class TupleArrayNode: public ArrayNodeBase {
+  public:
+    TupleArrayNode(
+      const Natural<> tupleSize_, const SourceLocation &sourceLocation_
+    ): ArrayNodeBase(sourceLocation_), tupleSize(tupleSize_) {
+    }
+    Natural<> getSize() const override {
+      return tupleSize > 0 ? values.size() / tupleSize : 0;
+    }
+    std::string getElementString(const Natural<> index) const override {
+      std::stringstream stream;
+      stream << std::setprecision(17) << "[";
+      for (Natural<> j(0); j < tupleSize; ++j) {
+        stream << (j > 0 ? ", " : "") << values[index*tupleSize + j];
+      }
+      stream << "]";
+      return stream.str();
+    }
+    Ptr<Node> getElement(const Natural<> index) const override {
+      return New<ArrayNode<AtomicType>>(getTuple(index), sourceLocation);
+    }
+    bool hasAtomicElements() const override {
+      return false;
+    }
+    std::vector<AtomicType> getTuple(const Natural<> index) const {
+      return std::vector<AtomicType>(
+        values.begin() + index*tupleSize, values.begin() + (index+1)*tupleSize
+      );
+    }
+
+    Natural<> tupleSize;
+    std::vector<AtomicType> values;
+  };
+
   class MapNode: public Node {
   public:
-    MapNode(const SourceLocation &sourceLocation_): Node(sourceLocation_) {
+    MapNode(
+      const SourceLocation &sourceLocation_
+    ): Node(sourceLocation_), nonNullSize(0) {
     }
     bool isAtomic() override {
       return false;
@@ -126,11 +247,19 @@ namespace cc4s {
       return keys;
     }
 
+    /**
+     * \brief Returns the number of non-null elements. Maps without null
+     * elements, such as sequences built by push_back, are counted only once
+     * until elements are entered. Null elements are entered when looking
+     * up absent keys.
+     **/
     Natural<> getSize() const {
+      if (nonNullSize == elements.size()) return nonNullSize;
       Natural<> size(0);
-      for (auto pair: elements) {
+      for (auto &pair: elements) {
         if (pair.second) ++size;
       }
+      if (size == elements.size()) nonNullSize = size;
       return size;
     }
 
@@ -259,6 +388,17 @@ namespace cc4s {
       ASSERT_LOCATION(
         get(element), "expecting key '" + element + "'", sourceLocation
       );
+      auto arrayNode(get(element)->toPtr<ArrayNodeBase>());
+      if (arrayNode) {
+        // provide arrays as sequences for code expecting maps, replacing
+        // the array such that changes to the returned map are retained
+        auto mapNode(New<MapNode>(arrayNode->sourceLocation));
+        for (Natural<> i(0); i < arrayNode->getSize(); ++i) {
+          mapNode->get(i) = arrayNode->getElement(i);
+        }
+        get(element) = mapNode;
+        return mapNode;
+      }
       auto mapNode(get(element)->toPtr<MapNode>());
       ASSERT_LOCATION(
         mapNode, "expecting '" + element + "' to be a map", sourceLocation
@@ -269,12 +409,117 @@ namespace cc4s {
       return getMap(std::to_string(element));
     }
 
+    /**
+     * \brief Returns the given element as dense array of the Target type.
+     * Sequences given as maps or arrays of other types are converted
+     * and replaced by the converted array. Numbers are converted only if
+     * they are representable in the Target type.
+     **/
+    template <typename Target>
+    Ptr<ArrayNode<Target>> getArray(const std::string &element) {
+      ASSERT_LOCATION(
+        get(element), "expecting key '" + element + "'", sourceLocation
+      );
+      auto targetArrayNode(get(element)->toPtr<ArrayNode<Target>>());
+      if (targetArrayNode) return targetArrayNode;
+      targetArrayNode = New<ArrayNode<Target>>(get(element)->sourceLocation);
+      if (
+        !convertNumbers<Target,ArrayNode>(
+          get(element), targetArrayNode->values, element
+        )
+      ) {
+        // convert from sequence given as map
+        auto mapNode(getMap(element));
+        auto size(mapNode->getSize());
+        targetArrayNode->values.resize(size);
+        for (Natural<> i(0); i < size; ++i) {
+          ASSERT_LOCATION(
+            mapNode->get(i), "expecting element " + std::to_string(i) +
+              " in '" + element + "'", mapNode->sourceLocation
+          );
+          targetArrayNode->values[i] = convertAtom<Target>(
+            mapNode->get(i), element
+          );
+        }
+      }
+      get(element) = targetArrayNode;
+      return targetArrayNode;
+    }
+    template <typename Target>
+    Ptr<ArrayNode<Target>> getArray(const Natural<> element) {
+      return getArray<Target>(std::to_string(element));
+    }
+
+    /**
+     * \brief Returns the given element as dense array of equally long
+     * tuples of the Target type. Sequences of sequences given as maps or
+     * tuple arrays of other types are converted and replaced by the
+     * converted tuple array.
+     **/
+    template <typename Target>
+    Ptr<TupleArrayNode<Target>> getTupleArray(const std::string &element) {
+      ASSERT_LOCATION(
+        get(element), "expecting key '" + element + "'", sourceLocation
+      );
+      auto targetArrayNode(get(element)->toPtr<TupleArrayNode<Target>>());
+      if (targetArrayNode) return targetArrayNode;
+      auto tupleArrayNode(get(element)->toPtr<ArrayNodeBase>());
+      if (tupleArrayNode && !tupleArrayNode->hasAtomicElements()) {
+        // convert from tuple array of other type
+        targetArrayNode = New<TupleArrayNode<Target>>(
+          0, tupleArrayNode->sourceLocation
+        );
+        auto isConverted(
+          convertNumbers<Target,TupleArrayNode>(
+            tupleArrayNode, targetArrayNode->values, element
+          )
+        );
+        ASSERT_LOCATION(
+          isConverted,
+          "expecting '" + element + "' to be a sequence of number sequences",
+          tupleArrayNode->sourceLocation
+        );
+        auto size(tupleArrayNode->getSize());
+        if (size > 0) {
+          targetArrayNode->tupleSize = targetArrayNode->values.size() / size;
+        }
+      } else {
+        // convert from sequence of sequences given as map
+        auto mapNode(getMap(element));
+        auto size(mapNode->getSize());
+        targetArrayNode = New<TupleArrayNode<Target>>(
+          0, mapNode->sourceLocation
+        );
+        for (Natural<> i(0); i < size; ++i) {
+          auto tuple(mapNode->getArray<Target>(i));
+          if (i == 0) {
+            targetArrayNode->tupleSize = tuple->getSize();
+            targetArrayNode->values.reserve(size * tuple->getSize());
+          }
+          ASSERT_LOCATION(
+            tuple->getSize() == targetArrayNode->tupleSize,
+            "expecting sequences of equal length in '" + element + "'",
+            tuple->sourceLocation
+          );
+          targetArrayNode->values.insert(
+            targetArrayNode->values.end(),
+            tuple->values.begin(), tuple->values.end()
+          );
+        }
+      }
+      get(element) = targetArrayNode;
+      return targetArrayNode;
+    }
+
     bool isGiven(const std::string &element) {
       return elements.find(element) != elements.end();
     }
 
     void push_back(const Ptr<Node> &node) {
-      get(getSize()) = node;
+      auto size(getSize());
+      auto isWithoutNull(size == elements.size());
+      get(size) = node;
+      if (isWithoutNull && node) nonNullSize = size + 1;
     }
 
     std::vector<std::string> getKeys() {
@@ -289,6 +534,151 @@ namespace cc4s {
     }
 
   protected:
+    /**
+     * \brief Whether the given integral value is representable in the
+     * integral Target type.
+     **/
+    template <typename Target, typename Source>
+    static typename std::enable_if<
+      std::is_integral<Target>::value && std::is_integral<Source>::value, bool
+    >::type isRepresentable(const Source value) {
+      auto targetValue(static_cast<Target>(value));
+      return static_cast<Source>(targetValue) == value &&
+        (targetValue < Target(0)) == (value < Source(0));
+    }
+    /**
+     * \brief Whether the given floating point value is integral and within
+     * the range of the integral Target type.
+     **/
+    template <typename Target, typename Source>
+    static typename std::enable_if<
+      std::is_integral<Target>::value && std::is_floating_point<Source>::value,
+      bool
+    >::type isRepresentable(const Source value) {
+      return std::trunc(value) == value &&
+        value >= static_cast<Source>(std::numeric_limits<Target>::min()) &&
+        value < std::ldexp(Source(1), std::numeric_limits<Target>::digits);
+    }
+    /**
+     * \brief Floating point and complex targets represent all numbers,
+     * possibly rounded.
+     **/
+    template <typename Target, typename Source>
+    static typename std::enable_if<
+      !std::is_integral<Target>::value, bool
+    >::type isRepresentable(const Source) {
+      return true;
+    }
+
+    /**
+     * \brief Converts the given number to the Target type, throwing if it
+     * is not representable.
+     **/
+    template <typename Target, typename Source>
+    static Target convertNumber(
+      const Source value, const std::string &element,
+      const SourceLocation &sourceLocation
+    ) {
+      if (!isRepresentable<Target>(value)) {
+        std::stringstream stream;
+        stream << std::setprecision(17) << value;
+        THROW_LOCATION(
+          "failed to convert '" + stream.str() + "' in '" + element +
+            "' to " + TypeTraits<Target>::getName(),
+          sourceLocation
+        );
+      }
+      return static_cast<Target>(value);
+    }
+
+    /**
+     * \brief Converts the values of the given node to the Target type,
+     * if it is an Array of Source values. Returns false otherwise.
+     **/
+    template <
+      typename Target, typename Source, template <typename> class Array
+    >
+    static bool convertArray(
+      const Ptr<Node> &node, std::vector<Target> &targetValues,
+      const std::string &element
+    ) {
+      auto arrayNode(node->toPtr<Array<Source>>());
+      if (!arrayNode) return false;
+      targetValues.resize(arrayNode->values.size());
+      for (Natural<> i(0); i < arrayNode->values.size(); ++i) {
+        targetValues[i] = convertNumber<Target>(
+          arrayNode->values[i], element, arrayNode->sourceLocation
+        );
+      }
+      return true;
+    }
+    /**
+     * \brief Converts the values of the given node to the Target type,
+     * if it is an Array of any of the number types entered by the Parser or
+     * the algorithms. Returns false otherwise.
+     **/
+    template <typename Target, template <typename> class Array>
+    static bool convertNumbers(
+      const Ptr<Node> &node, std::vector<Target> &targetValues,
+      const std::string &element
+    ) {
+      return
+        convertArray<Target,Integer<64>,Array>(node, targetValues, element) ||
+        convertArray<Target,Natural<64>,Array>(node, targetValues, element) ||
+        convertArray<Target,Real<64>,Array>(node, targetValues, element);
+    }
+
+    /**
+     * \brief Converts the given atomic node of the given sequence to the
+     * Target type. Numbers are converted directly, other atoms by their
+     * string representation, which must be consumed entirely.
+     **/
+    template <typename Target>
+    static Target convertAtom(
+      const Ptr<Node> &node, const std::string &element
+    ) {
+      auto targetNode(node->toPtr<AtomicNode<Target>>());
+      if (targetNode) return targetNode->value;
+      auto integerNode(node->toPtr<AtomicNode<Integer<64>>>());
+      if (integerNode) {
+        return convertNumber<Target>(
+          integerNode->value, element, node->sourceLocation
+        );
+      }
+      auto naturalNode(node->toPtr<AtomicNode<Natural<64>>>());
+      if (naturalNode) {
+        return convertNumber<Target>(
+          naturalNode->value, element, node->sourceLocation
+        );
+      }
+      auto realNode(node->toPtr<AtomicNode<Real<64>>>());
+      if (realNode) {
+        return convertNumber<Target>(
+          realNode->value, element, node->sourceLocation
+        );
+      }
+      auto value(node->toString());
+      std::stringstream stream(value);
+      Target targetValue;
+      stream >> targetValue;
+      bool negativeUnsigned(
+        std::is_unsigned<Target>::value &&
+        value.find('-') != std::string::npos
+      );
+      if (stream.fail() || !(stream >> std::ws).eof() || negativeUnsigned) {
+        THROW_LOCATION(
+          "failed to convert '" + value + "' in '" + element + "' to " +
+            TypeTraits<Target>::getName(),
+          node->sourceLocation
+        );
+      }
+      return targetValue;
+    }
+
+    /**
+     * \brief Number of non-null elements if there are no null elements.
+     **/
+    mutable Natural<> nonNullSize;
     std::map<std::string,Ptr<Node>> elements;
   };
 }
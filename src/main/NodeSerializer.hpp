@@ -0,0 +1,295 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NODE_SERIALIZER_DEFINED
+#define NODE_SERIALIZER_DEFINED
+
+#include <Node.hpp>
+#include <Complex.hpp>
+#include <Exception.hpp>
+#include <SharedPointer.hpp>
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+namespace cc4s {
+  /**
+   * \brief Compact binary serialization of node trees consisting of
+   * maps, arrays, symbols and primitive atoms, as created by the Parser.
+   * Each node is stored as a one byte type tag, its source line and
+   * its content. Strings and arrays are preceded by their length.
+   * The source file is given once for the entire tree.
+   */
+  class NodeSerializer {
+  public:
+    static std::string serialize(const Ptr<Node> &node) {
+      std::string data;
+      serialize(node, data);
+      return data;
+    }
+
+    static Ptr<Node> deserialize(
+      const std::string &data, const std::string &fileName
+    ) {
+      Natural<> position(0);
+      auto node(deserialize(data, position, fileName));
+      ASSERT_LOCATION(
+        position == data.size(), "Trailing data in serialized node tree",
+        SourceLocation(fileName, 0)
+      );
+      return node;
+    }
+
+  protected:
+    static void serialize(const Ptr<Node> &node, std::string &data) {
+      auto mapNode(node->toPtr<MapNode>());
+      if (mapNode) {
+        put('M', node, data);
+        auto keys(mapNode->getKeys());
+        putWord(keys.size(), data);
+        for (auto &key: keys) {
+          putString(key, data);
+          serialize(mapNode->get(key), data);
+        }
+        return;
+      }
+      auto symbolNode(node->toPtr<SymbolNode>());
+      if (symbolNode) {
+        put('S', node, data);
+        putString(symbolNode->value, data);
+        return;
+      }
+      if (serializeArray<int64_t>('i', node, data)) return;
+      if (serializeArray<Natural<>>('n', node, data)) return;
+      if (serializeArray<Real<>>('r', node, data)) return;
+      if (serializeTupleArray<int64_t>('j', node, data)) return;
+      if (serializeTupleArray<Natural<>>('m', node, data)) return;
+      auto textNode(node->toPtr<AtomicNode<std::string>>());
+      if (textNode) {
+        put('T', node, data);
+        putString(textNode->value, data);
+        return;
+      }
+      if (serializeAtom<int64_t>('I', node, data)) return;
+      if (serializeAtom<Natural<>>('N', node, data)) return;
+      if (serializeAtom<Real<>>('R', node, data)) return;
+      if (serializeAtom<Complex<>>('C', node, data)) return;
+      if (serializeAtom<bool>('B', node, data)) return;
+      throw New<Exception>(
+        "Cannot serialize node of unsupported type", node->sourceLocation
+      );
+    }
+
+    static Ptr<Node> deserialize(
+      const std::string &data, Natural<> &position, const std::string &fileName
+    ) {
+      auto tag(getValue<char>(data, position, fileName));
+      SourceLocation sourceLocation(
+        fileName, getValue<Natural<>>(data, position, fileName)
+      );
+      switch (tag) {
+      case 'M': {
+        auto mapNode(New<MapNode>(sourceLocation));
+        auto size(getValue<Natural<>>(data, position, fileName));
+        for (Natural<> i(0); i < size; ++i) {
+          auto key(getString(data, position, fileName));
+          mapNode->get(key) = deserialize(data, position, fileName);
+        }
+        return mapNode;
+      }
+      case 'S':
+        return New<SymbolNode>(
+          getString(data, position, fileName), sourceLocation
+        );
+      case 'T':
+        return New<AtomicNode<std::string>>(
+          getString(data, position, fileName), sourceLocation
+        );
+      case 'i':
+        return deserializeArray<int64_t>(data, position, sourceLocation);
+      case 'n':
+        return deserializeArray<Natural<>>(data, position, sourceLocation);
+      case 'r':
+        return deserializeArray<Real<>>(data, position, sourceLocation);
+      case 'j':
+        return deserializeTupleArray<int64_t>(data, position, sourceLocation);
+      case 'm':
+        return deserializeTupleArray<Natural<>>(
+          data, position, sourceLocation
+        );
+      case 'I':
+        return deserializeAtom<int64_t>(data, position, sourceLocation);
+      case 'N':
+        return deserializeAtom<Natural<>>(data, position, sourceLocation);
+      case 'R':
+        return deserializeAtom<Real<>>(data, position, sourceLocation);
+      case 'C':
+        return deserializeAtom<Complex<>>(data, position, sourceLocation);
+      case 'B':
+        return deserializeAtom<bool>(data, position, sourceLocation);
+      default:
+        throw New<Exception>(
+          "Unknown node type in serialized node tree", sourceLocation
+        );
+      }
+    }
+
+    template <typename AtomicType>
+    static bool serializeAtom(
+      const char tag, const Ptr<Node> &node, std::string &data
+    ) {
+      auto atomicNode(node->toPtr<AtomicNode<AtomicType>>());
+      if (!atomicNode) return false;
+      put(tag, node, data);
+      putValue(atomicNode->value, data);
+      return true;
+    }
+
+    template <typename AtomicType>
+    static bool serializeArray(
+      const char tag, const Ptr<Node> &node, std::string &data
+    ) {
+      auto arrayNode(node->toPtr<ArrayNode<AtomicType>>());
+      if (!arrayNode) return false;
+      put(tag, node, data);
+      putWord(arrayNode->values.size(), data);
+      data.append(
+        reinterpret_cast<const char *>(arrayNode->values.data()),
+        sizeof(AtomicType) * arrayNode->values.size()
+      );
+      return true;
+    }
+
+    template <typename AtomicType>
+    static bool serializeTupleArray(
+      const char tag, const Ptr<Node> &node, std::string &data
+    ) {
+      auto arrayNode(node->toPtr<TupleArrayNode<AtomicType>>());
+      if (!arrayNode) return false;
+      put(tag, node, data);
+      putWord(arrayNode->tupleSize, data);
+      putWord(arrayNode->values.size(), data);
+      data.append(
+        reinterpret_cast<const char *>(arrayNode->values.data()),
+        sizeof(AtomicType) * arrayNode->values.size()
+      );
+      return true;
+    }
+
+    template <typename AtomicType>
+    static Ptr<Node> deserializeAtom(
+      const std::string &data, Natural<> &position,
+      const SourceLocation &sourceLocation
+    ) {
+      return New<AtomicNode<AtomicType>>(
+        getValue<AtomicType>(data, position, sourceLocation.getFile()),
+        sourceLocation
+      );
+    }
+
+    template <typename AtomicType>
+    static Ptr<Node> deserializeArray(
+      const std::string &data, Natural<> &position,
+      const SourceLocation &sourceLocation
+    ) {
+      auto size(getValue<Natural<>>(data, position, sourceLocation.getFile()));
+      check(data, position, sizeof(AtomicType) * size, sourceLocation.getFile());
+      auto arrayNode(New<ArrayNode<AtomicType>>(sourceLocation));
+      arrayNode->values.resize(size);
+      std::memcpy(
+        arrayNode->values.data(), data.data() + position,
+        sizeof(AtomicType) * size
+      );
+      position += sizeof(AtomicType) * size;
+      return arrayNode;
+    }
+
+    template <typename AtomicType>
+    static Ptr<Node> deserializeTupleArray(
+      const std::string &data, Natural<> &position,
+      const SourceLocation &sourceLocation
+    ) {
+      auto tupleSize(
+        getValue<Natural<>>(data, position, sourceLocation.getFile())
+      );
+      auto size(getValue<Natural<>>(data, position, sourceLocation.getFile()));
+      check(data, position, sizeof(AtomicType) * size, sourceLocation.getFile());
+      auto arrayNode(
+        New<TupleArrayNode<AtomicType>>(tupleSize, sourceLocation)
+      );
+      arrayNode->values.resize(size);
+      std::memcpy(
+        arrayNode->values.data(), data.data() + position,
+        sizeof(AtomicType) * size
+      );
+      position += sizeof(AtomicType) * size;
+      return arrayNode;
+    }
+
+    static void put(const char tag, const Ptr<Node> &node, std::string &data) {
+      putValue(tag, data);
+      putWord(node->sourceLocation.getLine(), data);
+    }
+
+    static void putWord(const Natural<> word, std::string &data) {
+      putValue(word, data);
+    }
+
+    static void putString(const std::string &value, std::string &data) {
+      putWord(value.size(), data);
+      data.append(value);
+    }
+
+    template <typename AtomicType>
+    static void putValue(const AtomicType &value, std::string &data) {
+      data.append(reinterpret_cast<const char *>(&value), sizeof(AtomicType));
+    }
+
+    static void check(
+      const std::string &data, const Natural<> position, const Natural<> size,
+      const std::string &fileName
+    ) {
+      ASSERT_LOCATION(
+        position + size <= data.size(), "Truncated serialized node tree",
+        SourceLocation(fileName, 0)
+      );
+    }
+
+    template <typename AtomicType>
+    static AtomicType getValue(
+      const std::string &data, Natural<> &position, const std::string &fileName
+    ) {
+      check(data, position, sizeof(AtomicType), fileName);
+      AtomicType value;
+      std::memcpy(&value, data.data() + position, sizeof(AtomicType));
+      position += sizeof(AtomicType);
+      return value;
+    }
+
+    static std::string getString(
+      const std::string &data, Natural<> &position, const std::string &fileName
+    ) {
+      auto size(getValue<Natural<>>(data, position, fileName));
+      check(data, position, size, fileName);
+      std::string value(data, position, size);
+      position += size;
+      return value;
+    }
+  };
+}
+
+#endif
+
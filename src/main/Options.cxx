@@ -14,9 +14,36 @@
  */
 
 #include <Options.hpp>
+#include <Exception.hpp>
 
 #include <string>
 #include <sstream>
 
 using namespace cc4s;
 
+size_t Options::getMemoryPerRank() const {
+  if (memoryPerRank.size() == 0) return 0;
+  std::stringstream stream(memoryPerRank);
+  double size(0);
+  std::string unit;
+  stream >> size;
+  bool valid(!stream.fail() && size > 0);
+  stream >> unit;
+  // accept no unit, a power of 1024 or bytes, e.g. 4G, 4GB or 4096MiB
+  std::string units("KMGT");
+  size_t exponent(0);
+  if (unit.size() > 0 && units.find(toupper(unit[0])) != std::string::npos) {
+    exponent = units.find(toupper(unit[0])) + 1;
+    unit = unit.substr(1);
+    if (unit == "i" || unit == "iB") unit = unit.substr(1);
+  }
+  valid = valid && (unit == "" || unit == "B") && (stream >> std::ws).eof();
+  if (!valid) {
+    THROW(
+      "Invalid memory per rank '" + memoryPerRank + "', expecting a positive "
+      "size in bytes optionally followed by K, M, G or T, e.g. 3.5G"
+    );
+  }
+  for (size_t e(0); e < exponent; ++e) size *= 1024;
+  return static_cast<size_t>(size);
+}
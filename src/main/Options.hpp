@@ -23,7 +23,8 @@ namespace cc4s {
 
   struct Options {
 
-    std::string inFile, logFile, yamlOutFile;
+    std::string inFile, logFile, logVerbosity, yamlOutFile;
+    std::string memoryPerRank, cacheDirectory;
     int dryRanks;
     CLI::App app;
     int argc;
@@ -32,7 +33,10 @@ namespace cc4s {
     Options(int _argc, char **_argv)
       : inFile("cc4s.in")
       , logFile("cc4s.log")
+      , logVerbosity("1")
       , yamlOutFile("cc4s.out.yaml")
+      , memoryPerRank("")
+      , cacheDirectory("cc4s.cache")
       , dryRanks(0)
       , app{"CC4S: Coupled Cluster For Solids"}
       , argc(_argc)
@@ -44,6 +48,12 @@ namespace cc4s {
          ->default_val(yamlOutFile);
       app.add_option("-l,--log", logFile, "Output log file")
          ->default_val(logFile);
+      app.add_option("--log-verbosity",
+                     logVerbosity,
+                    "Comma separated verbosity levels of log categories,\n"
+                    "e.g. 1,tcc=2,memory=0. A level without category\n"
+                    "applies to all other categories")
+         ->default_val(logVerbosity);
       app.add_option("-d,--dry-ranks",
                      dryRanks,
                     "Number of processes for dry run.\n"
@@ -51,8 +61,30 @@ namespace cc4s {
                     "If non-zero, specifies number ranks for resource\n"
                     "estimation and do not run after dry run")
          ->default_val(dryRanks);
+      app.add_option("-m,--memory-per-rank",
+                     memoryPerRank,
+                    "Memory available to each rank, e.g. 3.5G.\n"
+                    "Algorithms, tensor contractions and buffers are\n"
+                    "sized accordingly. If not given, the physical memory\n"
+                    "of each node is divided among its ranks");
+      app.add_option("--cache-directory",
+                     cacheDirectory,
+                    "Directory of the outputs of steps with 'cache: true',\n"
+                    "which are reused if the algorithm and its arguments\n"
+                    "match. Input tensors are identified by the step that\n"
+                    "produced them or by the path, size and modification\n"
+                    "time of the file they were read from, their elements\n"
+                    "are never read for this")
+         ->default_val(cacheDirectory);
     }
 
+    /**
+     * \brief Returns the memory per rank given in bytes, or with one of the
+     * suffixes K, M, G or T, and 0 if not given. Throws if the given
+     * memory cannot be parsed.
+     **/
+    size_t getMemoryPerRank() const;
+
     int parse() {
       CLI11_PARSE(app, argc, argv);
       return 0;
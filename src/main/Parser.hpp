@@ -17,11 +17,13 @@
 #define PARSER_DEFINED
 
 #include <Node.hpp>
+#include <NodeSerializer.hpp>
 #include <Log.hpp>
 #include <SharedPointer.hpp>
 
 #include <yaml-cpp/yaml.h>
 #include <string>
+#include <vector>
 #include <istream>
 
 namespace cc4s {
@@ -48,11 +50,38 @@ namespace cc4s {
     }
 
     /**
-     * \brief Parses the cc4s yaml data contained in the stream.
-     * This method must be called with the same stream content on all processes.
+     * \brief Parses the cc4s yaml data contained in the file.
+     * This method must be called collectively on all processes.
+     * Only rank 0 reads the file and broadcasts the serialized node tree
+     * to all other ranks.
      */
     Ptr<Node> parse() {
       LOG() << "Parsing file " << fileName << std::endl;
+      std::string data;
+      Ptr<Exception> failure;
+      if (Cc4s::world->getRank() == 0) {
+        try {
+          data = NodeSerializer::serialize(parseFile());
+        } catch (const Ptr<Exception> &cause) {
+          failure = cause;
+        }
+      }
+      // all ranks fail if parsing failed on rank 0
+      std::vector<Natural<>> failed(1, failure ? 1 : 0);
+      Cc4s::world->broadcast(failed);
+      if (failed[0]) {
+        if (failure) throw failure;
+        throw New<Exception>(
+          std::string("Failed to load file ") + fileName + " on rank 0",
+          SOURCE_LOCATION
+        );
+      }
+      Cc4s::world->broadcast(data);
+      return NodeSerializer::deserialize(data, fileName);
+    }
+
+  protected:
+    Ptr<Node> parseFile() {
       try {
         YAML::Node yamlNode(YAML::LoadFile(fileName));
         return parseNode(yamlNode);
@@ -65,7 +94,6 @@ namespace cc4s {
       }
     }
 
-  protected:
     Ptr<Node> parseNode(const YAML::Node &yamlNode) {
       switch (yamlNode.Type()) {
       case YAML::NodeType::Map:
@@ -90,7 +118,14 @@ namespace cc4s {
       return node;
     }
 
-    Ptr<MapNode> parseSequence(const YAML::Node &yamlNode) {
+    Ptr<Node> parseSequence(const YAML::Node &yamlNode) {
+      // sequences of untagged numbers are parsed into dense arrays
+      auto arrayNode(parseNumberSequence(yamlNode));
+      if (arrayNode) return arrayNode;
+      // sequences of equally long sequences of untagged integers are
+      // parsed into dense tuple arrays, e.g. non-zero block indices
+      auto tupleArrayNode(parseTupleSequence(yamlNode));
+      if (tupleArrayNode) return tupleArrayNode;
       auto node(New<MapNode>(SourceLocation(fileName, yamlNode.Mark().line)));
       size_t index(0);
       for (auto subNode: yamlNode) {
@@ -99,6 +134,77 @@ namespace cc4s {
       return node;
     }
 
+    /**
+     * \brief Whether the given node is an untagged number, in which case
+     * isReal is set if it contains a decimal point.
+     **/
+    static bool isNumber(const YAML::Node &yamlNode, bool &isReal) {
+      if (!yamlNode.IsScalar() || yamlNode.Tag() != "?") return false;
+      auto &value(yamlNode.Scalar());
+      if (
+        value.size() == 0 ||
+        !(isdigit(value[0]) || value[0] == '-' || value[0] == '+') ||
+        value.find('(') != std::string::npos
+      ) {
+        return false;
+      }
+      if (value.find('.') != std::string::npos) isReal = true;
+      return true;
+    }
+
+    Ptr<Node> parseNumberSequence(const YAML::Node &yamlNode) {
+      if (yamlNode.size() == 0) return nullptr;
+      bool isReal(false);
+      for (auto subNode: yamlNode) {
+        if (!isNumber(subNode, isReal)) return nullptr;
+      }
+      if (isReal) {
+        return parseArray<Real<>>(yamlNode);
+      } else {
+        return parseArray<int64_t>(yamlNode);
+      }
+    }
+
+    Ptr<Node> parseTupleSequence(const YAML::Node &yamlNode) {
+      if (yamlNode.size() == 0) return nullptr;
+      size_t tupleSize(0);
+      for (auto subNode: yamlNode) {
+        if (!subNode.IsSequence() || subNode.size() == 0) return nullptr;
+        if (tupleSize == 0) tupleSize = subNode.size();
+        if (subNode.size() != tupleSize) return nullptr;
+        bool isReal(false);
+        for (auto element: subNode) {
+          if (!isNumber(element, isReal) || isReal) return nullptr;
+        }
+      }
+      auto node(
+        New<TupleArrayNode<int64_t>>(
+          tupleSize, SourceLocation(fileName, yamlNode.Mark().line)
+        )
+      );
+      node->values.reserve(tupleSize * yamlNode.size());
+      for (auto subNode: yamlNode) {
+        for (auto element: subNode) {
+          node->values.push_back(element.as<int64_t>());
+        }
+      }
+      return node;
+    }
+
+    template <typename AtomicType>
+    Ptr<ArrayNode<AtomicType>> parseArray(const YAML::Node &yamlNode) {
+      auto node(
+        New<ArrayNode<AtomicType>>(
+          SourceLocation(fileName, yamlNode.Mark().line)
+        )
+      );
+      node->values.reserve(yamlNode.size());
+      for (auto subNode: yamlNode) {
+        node->values.push_back(subNode.as<AtomicType>());
+      }
+      return node;
+    }
+
     Ptr<Node> parseScalar(const YAML::Node &yamlNode) {
       // use explicitly node type, if given
       auto tag(yamlNode.Tag());
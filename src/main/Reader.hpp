@@ -30,9 +30,15 @@ namespace cc4s {
    */
   class Reader {
   public:
+    /**
+     * \brief Creates a reader for the given file name. The given options
+     * are passed on to the type-specific read functions, e.g.
+     * begins and ends of the tensor range to read.
+     **/
     Reader(
-      const std::string &pathFileName_
-    ): pathFileName(pathFileName_) {
+      const std::string &pathFileName_,
+      const Ptr<MapNode> &options_ = New<MapNode>(SOURCE_LOCATION)
+    ): pathFileName(pathFileName_), options(options_) {
     }
     Ptr<Node> read() {
       auto dotPosition(pathFileName.rfind('.'));
@@ -71,7 +77,10 @@ namespace cc4s {
     }
 
     typedef std::function<
-      Ptr<Node>(const Ptr<MapNode> &node, const std::string &nodePath)
+      Ptr<Node>(
+        const Ptr<MapNode> &node, const std::string &nodePath,
+        const Ptr<MapNode> &options
+      )
     > ReadFunction;
     static int registerReadFunction(
       const std::string &name, ReadFunction readFunction
@@ -106,7 +115,7 @@ namespace cc4s {
       if (readFunction != readFunctions.end()) {
         // if yes, call respective handler read function to translate into
         // node of working tree
-        return readFunction->second(mapNode, nodePath);
+        return readFunction->second(mapNode, nodePath, options);
       } else {
         // otherwise: translate sub nodes
         auto workingMapNode(New<MapNode>(mapNode->sourceLocation));
@@ -122,6 +131,7 @@ namespace cc4s {
     }
 
     std::string pathFileName;
+    Ptr<MapNode> options;
   };
 }
 
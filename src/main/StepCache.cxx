@@ -0,0 +1,204 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <StepCache.hpp>
+
+#include <Cc4s.hpp>
+#include <Reader.hpp>
+#include <Writer.hpp>
+#include <TensorIo.hpp>
+#include <TensorSet.hpp>
+#include <algorithms/Algorithm.hpp>
+#include <Log.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <sys/stat.h>
+
+using namespace cc4s;
+
+const Natural<32> StepCache::VERSION = 1;
+
+StepCache::StepCache(const std::string &directory_): directory(directory_) {
+}
+
+std::string StepCache::getKey(
+  const std::string &algorithmName, const Ptr<MapNode> &arguments
+) {
+  Natural<> h(0xcbf29ce484222325);
+  // outputs of other versions or cache formats must not be reused
+  hash(CC4S_VERSION, h);
+  hash(&VERSION, sizeof(VERSION), h);
+  hash(algorithmName, h);
+  if (!hash(arguments, h)) return "";
+  std::stringstream key;
+  key << algorithmName << "-" << std::hex << std::setw(16)
+    << std::setfill('0') << h;
+  return key.str();
+}
+
+Ptr<MapNode> StepCache::read(const std::string &key) {
+  if (key.size() == 0) return nullptr;
+  auto fileName(getFileName(key));
+  // only rank 0 checks for the file
+  std::vector<Natural<>> exists(1, 0);
+  if (Cc4s::world->getRank() == 0) {
+    exists[0] = std::ifstream(fileName).good();
+  }
+  Cc4s::world->broadcast(exists);
+  if (!exists[0]) return nullptr;
+  OUT() << "Reading cached output from " << fileName << std::endl;
+  auto output(Reader(fileName).read()->toPtr<MapNode>());
+  ASSERT_LOCATION(
+    output, "Expecting map as cached output", SourceLocation(fileName, 0)
+  );
+  return output;
+}
+
+void StepCache::write(const std::string &key, const Ptr<MapNode> &output) {
+  if (key.size() == 0) {
+    WARNING() << "Output cannot be cached since the arguments cannot be hashed"
+      << std::endl;
+    return;
+  }
+  if (Cc4s::world->getRank() == 0) {
+    mkdir(directory.c_str(), 0755);
+  }
+  Cc4s::world->barrier();
+  auto fileName(getFileName(key));
+  OUT() << "Writing output to cache " << fileName << std::endl;
+  auto options(New<MapNode>(SOURCE_LOCATION));
+  options->setValue<std::string>("elementsType", "IeeeBinaryFile");
+  Writer(fileName, options).write(output);
+}
+
+void StepCache::setProvenance(const std::string &key, const Ptr<Node> &output) {
+  if (key.size() == 0) return;
+  auto mapNode(output->toPtr<MapNode>());
+  if (mapNode) {
+    for (auto subKey: mapNode->getKeys()) {
+      setProvenance(key + "." + subKey, mapNode->get(subKey));
+    }
+    return;
+  }
+  auto pointerNode(output->toPtr<AtomicNode<Ptr<Object>>>());
+  if (pointerNode && pointerNode->value) {
+    Natural<> h(0xcbf29ce484222325);
+    hash(key, h);
+    auto object(pointerNode->value.get());
+    provenances[object] = std::make_pair(pointerNode->value, h);
+  }
+}
+
+std::string StepCache::getFileName(const std::string &key) {
+  return directory + "/" + key + ".yaml";
+}
+
+bool StepCache::hash(const Ptr<Node> &node, Natural<> &h) {
+  auto mapNode(node->toPtr<MapNode>());
+  if (mapNode) {
+    hash("{", h);
+    for (auto key: mapNode->getKeys()) {
+      hash(key, h);
+      if (!hash(mapNode->get(key), h)) return false;
+    }
+    hash("}", h);
+    return true;
+  }
+  auto arrayNode(node->toPtr<ArrayNodeBase>());
+  if (arrayNode) {
+    hash("[", h);
+    for (Natural<> i(0); i < arrayNode->getSize(); ++i) {
+      hash(arrayNode->getElementString(i), h);
+    }
+    hash("]", h);
+    return true;
+  }
+  auto pointerNode(node->toPtr<AtomicNode<Ptr<Object>>>());
+  if (pointerNode) return hashObject(pointerNode->value, h);
+  // symbols and other atoms are hashed by their string representation
+  hash(node->toString(), h);
+  return true;
+}
+
+bool StepCache::hashObject(const Ptr<Object> &object, Natural<> &h) {
+  if (!object) return false;
+  auto provenance(provenances.find(object.get()));
+  if (provenance != provenances.end()) {
+    if (provenance->second.first.lock() == object) {
+      hash(&provenance->second.second, sizeof(Natural<>), h);
+      return true;
+    }
+    // the address has been reused by another object
+    provenances.erase(provenance);
+  }
+  using TE = DefaultTensorEngine;
+  Natural<> objectHash(0xcbf29ce484222325);
+  if (
+    !hashTensor<Real<>,TE>(object, objectHash) &&
+    !hashTensor<Complex<>,TE>(object, objectHash) &&
+    !hashTensorSet<Real<>,TE>(object, objectHash) &&
+    !hashTensorSet<Complex<>,TE>(object, objectHash)
+  ) return false;
+  // remember the content hash for later steps using the same object
+  provenances[object.get()] = std::make_pair(object, objectHash);
+  hash(&objectHash, sizeof(Natural<>), h);
+  return true;
+}
+
+template <typename F, typename TE>
+bool StepCache::hashTensor(const Ptr<Object> &object, Natural<> &h) {
+  auto tensorExpression(dynamicPtrCast<TensorExpression<F,TE>>(object));
+  if (!tensorExpression) return false;
+  // tensors without provenance are only hashed if they were read from a file
+  auto identity(TensorIo::getReadIdentity(object));
+  if (identity.size() == 0) {
+    LOG() << "Cannot hash tensor without provenance or file" << std::endl;
+    return false;
+  }
+  hash(TypeTraits<F>::getName(), h);
+  hash(identity, h);
+  return true;
+}
+
+template <typename F, typename TE>
+bool StepCache::hashTensorSet(const Ptr<Object> &object, Natural<> &h) {
+  auto tensorSet(dynamicPtrCast<TensorSet<F,TE>>(object));
+  if (!tensorSet) return false;
+  hash("{", h);
+  for (auto key: tensorSet->getKeys()) {
+    hash(key, h);
+    if (!hashObject(tensorSet->get(key), h)) return false;
+  }
+  hash("}", h);
+  return true;
+}
+
+void StepCache::hash(const void *data, const Natural<> size, Natural<> &h) {
+  // FNV-1a
+  auto bytes(static_cast<const unsigned char *>(data));
+  for (Natural<> i(0); i < size; ++i) {
+    h ^= bytes[i];
+    h *= 0x100000001b3;
+  }
+}
+
+void StepCache::hash(const std::string &value, Natural<> &h) {
+  Natural<> size(value.size());
+  hash(&size, sizeof(Natural<>), h);
+  hash(value.data(), value.size(), h);
+}
+
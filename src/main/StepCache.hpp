@@ -0,0 +1,109 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STEP_CACHE_DEFINED
+#define STEP_CACHE_DEFINED
+
+#include <Node.hpp>
+#include <Object.hpp>
+#include <SharedPointer.hpp>
+
+#include <string>
+#include <map>
+
+namespace cc4s {
+  /**
+   * \brief On-disk cache of step results addressed by their content.
+   * The key of a step is a hash of the cc4s and cache versions, the
+   * algorithm name and its input arguments. Objects like tensors enter
+   * the hash with their provenance, i.e. the key of the cached step that
+   * produced them and their location within its output. Tensors without
+   * provenance enter with the identity of the file they were read from,
+   * i.e. its path, size and modification time. Elements are never read
+   * for hashing. Steps with arguments of neither kind are not cached.
+   * All methods must be called collectively by all ranks.
+   **/
+  class StepCache {
+  public:
+    StepCache(const std::string &directory);
+
+    /**
+     * \brief Returns the key of a step running the given algorithm with
+     * the given arguments, where symbols are already replaced by their
+     * values. Returns an empty string if any argument cannot be hashed.
+     **/
+    std::string getKey(
+      const std::string &algorithmName, const Ptr<MapNode> &arguments
+    );
+
+    /**
+     * \brief Returns the output stored under the given key or nullptr
+     * if there is none.
+     **/
+    Ptr<MapNode> read(const std::string &key);
+
+    /**
+     * \brief Stores the given output under the given key.
+     * Tensors are written in binary format.
+     **/
+    void write(const std::string &key, const Ptr<MapNode> &output);
+
+    /**
+     * \brief Enters the provenance of all objects in the given output
+     * of the step with the given key. Objects are only referenced weakly.
+     * Only to be used for steps whose output depends on their arguments
+     * alone.
+     **/
+    void setProvenance(const std::string &key, const Ptr<Node> &output);
+
+    /**
+     * \brief Enters the given data into the given FNV-1a hash,
+     * which is to be started at 0xcbf29ce484222325.
+     **/
+    static void hash(const void *data, const Natural<> size, Natural<> &h);
+    static void hash(const std::string &value, Natural<> &h);
+
+  protected:
+    /**
+     * \brief Version of the cache. Increase it if cached outputs are
+     * no longer valid, e.g. when the key derivation changes.
+     **/
+    static const Natural<32> VERSION;
+
+    std::string getFileName(const std::string &key);
+
+    /**
+     * \brief Hashes the given node into the given FNV-1a hash.
+     * Returns false if the node cannot be hashed.
+     **/
+    bool hash(const Ptr<Node> &node, Natural<> &h);
+    bool hashObject(const Ptr<Object> &object, Natural<> &h);
+    template <typename F, typename TE>
+    bool hashTensor(const Ptr<Object> &object, Natural<> &h);
+    template <typename F, typename TE>
+    bool hashTensorSet(const Ptr<Object> &object, Natural<> &h);
+
+    std::string directory;
+    /**
+     * \brief Provenance hash of objects produced by earlier steps,
+     * only valid while the weakly referenced object still exists.
+     **/
+    std::map<const Object *, std::pair<WeakPtr<Object>, Natural<>>>
+      provenances;
+  };
+}
+
+#endif
+
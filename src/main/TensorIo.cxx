@@ -15,6 +15,9 @@
 
 #include <TensorIo.hpp>
 #include <Reader.hpp>
+#include <ByteShuffleCodec.hpp>
+
+#include <sys/stat.h>
 
 using namespace cc4s;
 
@@ -26,6 +29,167 @@ bool TensorIo::READ_REGISTERED =
 
 const Natural<32> TensorIo::VERSION = 100;
 
+const Natural<> TensorIo::MAX_CHUNK_ELEMENTS = 1024*1024;
+
+std::map<std::string, TensorIo::PendingWrite> TensorIo::pendingWrites;
+std::map<
+  const Object *, std::pair<WeakPtr<Object>, std::string>
+> TensorIo::readIdentities;
+
+// "CC4SCHNK" in little endian
+const Natural<> TensorChunks::MAGIC = 0x4b4e484353344343;
+
+
+TensorChunks::TensorChunks(
+  const std::vector<Natural<>> &lens_,
+  const Natural<> elementSize_,
+  const Natural<> maxChunkElements
+): lens(lens_), chunkLens(lens_), elementSize(elementSize_) {
+  for (auto &chunkLen: chunkLens) chunkLen = std::max(chunkLen, Natural<>(1));
+  // halve the longest chunk dimension until the chunk is small enough
+  auto chunkElementsCount([this]() {
+    Natural<> count(1);
+    for (auto len: chunkLens) count *= len;
+    return count;
+  });
+  while (chunkElementsCount() > maxChunkElements) {
+    Natural<> longest(0);
+    for (Natural<> d(1); d < chunkLens.size(); ++d) {
+      if (chunkLens[d] > chunkLens[longest]) longest = d;
+    }
+    chunkLens[longest] = (chunkLens[longest]+1) / 2;
+  }
+  Natural<> chunksCount(1);
+  for (Natural<> d(0); d < lens.size(); ++d) {
+    chunksCount *= (lens[d] + chunkLens[d] - 1) / chunkLens[d];
+  }
+  // uncompressed chunks follow the header contiguously
+  Natural<> offset(
+    sizeof(Natural<>) * getHeaderWords(lens.size(), chunksCount)
+  );
+  std::vector<Natural<>> begins, ends;
+  for (Natural<> c(0); c < chunksCount; ++c) {
+    offsets.push_back(offset);
+    sizes.push_back(0);
+    checksums.push_back(0);
+    getRange(c, begins, ends);
+    Natural<> size(elementSize);
+    for (Natural<> d(0); d < lens.size(); ++d) size *= ends[d] - begins[d];
+    sizes[c] = size;
+    offset += size;
+  }
+}
+
+void TensorChunks::getRange(
+  const Natural<> chunk,
+  std::vector<Natural<>> &begins,
+  std::vector<Natural<>> &ends
+) const {
+  begins.resize(lens.size());
+  ends.resize(lens.size());
+  Natural<> c(chunk);
+  for (Natural<> d(0); d < lens.size(); ++d) {
+    Natural<> chunksAlongD((lens[d] + chunkLens[d] - 1) / chunkLens[d]);
+    begins[d] = (c % chunksAlongD) * chunkLens[d];
+    ends[d] = std::min(begins[d] + chunkLens[d], lens[d]);
+    c /= chunksAlongD;
+  }
+}
+
+std::vector<Natural<>> TensorChunks::getIntersectingChunks(
+  const std::vector<Natural<>> &begins,
+  const std::vector<Natural<>> &ends
+) const {
+  std::vector<Natural<>> chunks;
+  for (Natural<> d(0); d < lens.size(); ++d) {
+    // empty ranges intersect no chunk
+    if (begins[d] >= ends[d]) return chunks;
+  }
+  // iterate over the chunk grid coordinates covering the range
+  std::vector<Natural<>> firsts(lens.size()), lasts(lens.size());
+  for (Natural<> d(0); d < lens.size(); ++d) {
+    firsts[d] = begins[d] / chunkLens[d];
+    lasts[d] = (ends[d]-1) / chunkLens[d];
+  }
+  std::vector<Natural<>> coordinates(firsts);
+  while (true) {
+    Natural<> chunk(0), stride(1);
+    for (Natural<> d(0); d < lens.size(); ++d) {
+      chunk += coordinates[d] * stride;
+      stride *= (lens[d] + chunkLens[d] - 1) / chunkLens[d];
+    }
+    chunks.push_back(chunk);
+    // next coordinates, carry if necessary
+    Natural<> d(0);
+    while (d < lens.size() && coordinates[d] == lasts[d]) {
+      coordinates[d] = firsts[d];
+      ++d;
+    }
+    if (d == lens.size()) break;
+    ++coordinates[d];
+  }
+  return chunks;
+}
+
+std::vector<Natural<>> TensorChunks::serialize() const {
+  std::vector<Natural<>> header;
+  header.reserve(getHeaderWords(lens.size(), getChunksCount()));
+  header.push_back(MAGIC);
+  header.push_back(elementSize);
+  header.push_back(lens.size());
+  header.insert(header.end(), lens.begin(), lens.end());
+  header.insert(header.end(), chunkLens.begin(), chunkLens.end());
+  header.push_back(getChunksCount());
+  for (Natural<> c(0); c < getChunksCount(); ++c) {
+    header.push_back(offsets[c]);
+    header.push_back(sizes[c]);
+    header.push_back(checksums[c]);
+  }
+  return header;
+}
+
+TensorChunks TensorChunks::deserialize(
+  const std::vector<Natural<>> &header,
+  const SourceLocation &sourceLocation
+) {
+  ASSERT_LOCATION(
+    header.size() >= 3 && header[0] == MAGIC,
+    "Not a chunked tensor elements file", sourceLocation
+  );
+  TensorChunks chunks;
+  chunks.elementSize = header[1];
+  auto order(header[2]);
+  ASSERT_LOCATION(
+    header.size() >= getHeaderWords(order, 0),
+    "Truncated chunked tensor elements header", sourceLocation
+  );
+  auto word(header.begin() + 3);
+  chunks.lens.assign(word, word + order);
+  word += order;
+  chunks.chunkLens.assign(word, word + order);
+  word += order;
+  auto chunksCount(*word++);
+  ASSERT_LOCATION(
+    header.size() == getHeaderWords(order, chunksCount),
+    "Truncated chunked tensor elements header", sourceLocation
+  );
+  for (Natural<> c(0); c < chunksCount; ++c) {
+    chunks.offsets.push_back(*word++);
+    chunks.sizes.push_back(*word++);
+    chunks.checksums.push_back(*word++);
+  }
+  return chunks;
+}
+
+Natural<> TensorChunks::getChecksum(const char *data, const Natural<> size) {
+  Natural<> hash(0xcbf29ce484222325);
+  for (Natural<> i(0); i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
 
 Ptr<TensorDimension> TensorIo::getDimension(const std::string &name) {
   // check if name is entetered in map
@@ -36,9 +200,14 @@ Ptr<TensorDimension> TensorIo::getDimension(const std::string &name) {
   tensorDimension->name = name;
   TensorDimension::dimensions[name] = tensorDimension;
 
-  // check if file exists specifying dimension properties
+  // check if file exists specifying dimension properties,
+  // only rank 0 accesses the file system, also when parsing
   auto dimensionFileName(name + ".yaml");
-  if (std::ifstream(dimensionFileName).good()) {
+  std::vector<Natural<>> isGiven(
+    1, Cc4s::world->getRank() == 0 && std::ifstream(dimensionFileName).good()
+  );
+  Cc4s::world->broadcast(isGiven);
+  if (isGiven[0]) {
     auto dimensionMap(
       Parser(dimensionFileName).parse()->toPtr<MapNode>()
     );
@@ -63,22 +232,32 @@ Ptr<TensorDimension> TensorIo::getDimension(const std::string &name) {
   return tensorDimension;
 }
 
+Natural<> TensorIo::getMaxBufferSize(const Natural<> elementSize) {
+  // use the buffers share of the memory but allow for at least 1M elements
+  return std::max(
+    Natural<>(1024*1024),
+    Cc4s::getMemoryShare(Cc4s::BUFFERS_MEMORY) /
+      (elementSize + sizeof(Natural<>))
+  );
+}
+
 Ptr<Node> TensorIo::write(
-  const Ptr<Node> &node, const std::string &nodePath, const bool useBinary
+  const Ptr<Node> &node, const std::string &nodePath,
+  const Ptr<MapNode> &options
 ) {
   // multiplex different tensor types
   Ptr<Node> writtenNode;
   if (!Cc4s::dryRun) {
     using TE = DefaultTensorEngine;
-    writtenNode = writeTensor<Real<64>,TE>(node, nodePath, useBinary);
+    writtenNode = writeTensor<Real<64>,TE>(node, nodePath, options);
     if (writtenNode) return writtenNode;
-    writtenNode = writeTensor<Complex<64>,TE>(node, nodePath, useBinary);
+    writtenNode = writeTensor<Complex<64>,TE>(node, nodePath, options);
     if (writtenNode) return writtenNode;
   } else {
     using TE = DefaultDryTensorEngine;
-    writtenNode = writeTensor<Real<64>,TE>(node, nodePath, useBinary);
+    writtenNode = writeTensor<Real<64>,TE>(node, nodePath, options);
     if (writtenNode) return writtenNode;
-    writtenNode = writeTensor<Complex<64>,TE>(node, nodePath, useBinary);
+    writtenNode = writeTensor<Complex<64>,TE>(node, nodePath, options);
     if (writtenNode) return writtenNode;
   }
   // otherwise, not my type ... let another write routine handle this data
@@ -86,23 +265,24 @@ Ptr<Node> TensorIo::write(
 }
 
 Ptr<Node> TensorIo::read(
-  const Ptr<MapNode> &node, const std::string &nodePath
+  const Ptr<MapNode> &node, const std::string &nodePath,
+  const Ptr<MapNode> &options
 ) {
   auto scalarType(node->getValue<std::string>("scalarType"));
   // multiplex different tensor types
   if (!Cc4s::dryRun) {
     using TE = DefaultTensorEngine;
     if (scalarType == TypeTraits<Real<64>>::getName()) {
-      return readTensor<Real<64>,TE>(node, nodePath);
+      return readTensor<Real<64>,TE>(node, nodePath, options);
     } else if (scalarType == TypeTraits<Complex<64>>::getName()) {
-      return readTensor<Complex<64>,TE>(node, nodePath);
+      return readTensor<Complex<64>,TE>(node, nodePath, options);
     }
   } else {
     using TE = DefaultDryTensorEngine;
     if (scalarType == TypeTraits<Real<64>>::getName()) {
-      return readTensor<Real<64>,TE>(node, nodePath);
+      return readTensor<Real<64>,TE>(node, nodePath, options);
     } else if (scalarType == TypeTraits<Complex<64>>::getName()) {
-      return readTensor<Complex<64>,TE>(node, nodePath);
+      return readTensor<Complex<64>,TE>(node, nodePath, options);
     }
   }
   std::stringstream explanation;
@@ -110,12 +290,108 @@ Ptr<Node> TensorIo::read(
   throw New<Exception>(explanation.str(), SOURCE_LOCATION);
 }
 
+void TensorIo::awaitWrite(const std::string &fileName) {
+  auto pendingWrite(pendingWrites.find(getAbsolutePath(fileName)));
+  if (pendingWrite == pendingWrites.end()) return;
+  LOG() << "Waiting for background write of " << pendingWrite->first <<
+    std::endl;
+  auto &requests(pendingWrite->second.requests);
+  MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+  MPI_File_close(&pendingWrite->second.file);
+  LOG() << "Written " << pendingWrite->second.buffer.size() <<
+    " bytes in background to binary file " << pendingWrite->first << std::endl;
+  pendingWrites.erase(pendingWrite);
+}
+
+void TensorIo::awaitWrites() {
+  // all ranks hold the same pending writes in the same order
+  while (!pendingWrites.empty()) {
+    awaitWrite(pendingWrites.begin()->first);
+  }
+}
+
+std::string TensorIo::getReadIdentity(const Ptr<Object> &tensor) {
+  auto identity(readIdentities.find(tensor.get()));
+  if (identity == readIdentities.end()) return "";
+  // the address may have been reused by another object
+  if (identity->second.first.lock() != tensor) return "";
+  return identity->second.second;
+}
+
+std::string TensorIo::getAbsolutePath(const std::string &fileName) {
+  if (fileName.size() > 0 && fileName[0] == '/') return fileName;
+  char currentDirectory[PATH_MAX];
+  getcwd(currentDirectory, sizeof(currentDirectory));
+  return std::string(currentDirectory) + "/" + fileName;
+}
+
+std::string TensorIo::getFileIdentity(const std::string &fileName) {
+  std::string identity;
+  if (Cc4s::world->getRank() == 0) {
+    struct stat status;
+    if (stat(fileName.c_str(), &status) == 0) {
+      identity = std::to_string(status.st_size) + ":" +
+        std::to_string(status.st_mtim.tv_sec) + "." +
+        std::to_string(status.st_mtim.tv_nsec);
+    }
+  }
+  Cc4s::world->broadcast(identity);
+  return identity;
+}
+
+void TensorIo::restrictToRange(
+  std::vector<Ptr<TensorDimension>> &dimensions,
+  Ptr<TensorNonZeroConditions> &nonZeroConditions,
+  const std::vector<Natural<>> &lens,
+  const std::vector<Natural<>> &begins,
+  const std::vector<Natural<>> &ends
+) {
+  // properties of the restricted dimensions by those of the entire ones
+  std::map<
+    Ptr<TensorDimensionProperty>, Ptr<TensorDimensionProperty>
+  > restrictedProperties;
+  for (Natural<> d(0); d < dimensions.size(); ++d) {
+    if (!dimensions[d] || (begins[d] == 0 && ends[d] == lens[d])) continue;
+    auto restricted(New<TensorDimension>());
+    // not entered in the table of named dimensions
+    restricted->name = dimensions[d]->name + "[" + std::to_string(begins[d]) +
+      ":" + std::to_string(ends[d]) + "]";
+    for (auto named: dimensions[d]->properties) {
+      auto property(New<TensorDimensionProperty>());
+      property->name = named.second->name;
+      auto first(named.second->propertyOfIndex.lower_bound(begins[d]));
+      auto last(named.second->propertyOfIndex.lower_bound(ends[d]));
+      for (auto entry(first); entry != last; ++entry) {
+        auto index(entry->first - begins[d]);
+        property->propertyOfIndex[index] = entry->second;
+        property->indicesOfProperty[entry->second].insert(index);
+      }
+      restricted->properties[named.first] = property;
+      restrictedProperties[named.second] = property;
+    }
+    dimensions[d] = restricted;
+  }
+  if (restrictedProperties.size() == 0) return;
+  auto restrictedConditions(New<TensorNonZeroConditions>());
+  for (auto condition: nonZeroConditions->all) {
+    auto restrictedCondition(New<TensorNonZeroCondition>(*condition));
+    for (auto &reference: restrictedCondition->dimensionPropertyReferences) {
+      auto restricted(restrictedProperties.find(reference.property));
+      if (restricted != restrictedProperties.end()) {
+        reference.property = restricted->second;
+      }
+    }
+    restrictedConditions->all.push_back(restrictedCondition);
+  }
+  nonZeroConditions = restrictedConditions;
+}
+
 
 template <typename F, typename TE>
 Ptr<MapNode> TensorIo::writeTensor(
   const Ptr<Node> &node,
   const std::string &nodePath,
-  const bool useBinary
+  const Ptr<MapNode> &options
 ) {
   auto pointerNode(node->toPtr<AtomicNode<Ptr<Object>>>());
   if (!pointerNode) return nullptr;
@@ -146,11 +422,57 @@ Ptr<MapNode> TensorIo::writeTensor(
   writtenTensor->get("metaData") = tensor->getMetaData();
 
   // write tensor elements as side effect
-  if (useBinary) {
-    elementsNode->setValue("type", std::string("IeeeBinaryFile"));
-    writeTensorElementsBinary(tensor, nodePath);
+  auto elementsType(
+    options->getValue<std::string>("elementsType", "TextFile")
+  );
+  auto async(options->getValue<bool>("async", false));
+  if (async && elementsType != "IeeeBinaryFile") {
+    WARNING_LOCATION(options->sourceLocation) <<
+      "Writing elements type " << elementsType << " synchronously. " <<
+      "Only IeeeBinaryFile can be written asynchronously." << std::endl;
+  }
+  if (
+    options->isGiven("errorBound") && elementsType != "CompressedBinaryFile"
+  ) {
+    WARNING_LOCATION(options->sourceLocation) <<
+      "Ignoring errorBound for elements type " << elementsType <<
+      ". Only CompressedBinaryFile elements are rounded." << std::endl;
+  }
+  if (elementsType == "IeeeBinaryFile") {
+    elementsNode->setValue("type", elementsType);
+    if (async) {
+      writeTensorElementsBinaryAsync(tensor, nodePath);
+    } else {
+      writeTensorElementsBinary(tensor, nodePath);
+    }
+  } else if (
+    elementsType == "ChunkedBinaryFile" ||
+    elementsType == "CompressedBinaryFile"
+  ) {
+    elementsNode->setValue("type", elementsType);
+    auto compressed(elementsType == "CompressedBinaryFile");
+    ASSERT_LOCATION(
+      !compressed || ByteShuffleCodec::isAvailable(),
+      "Elements type CompressedBinaryFile requires cc4s built with zlib",
+      options->sourceLocation
+    );
+    auto errorBound(
+      compressed ? options->getValue<Real<>>("errorBound", 0.0) : 0.0
+    );
+    auto chunkLens(
+      writeTensorElementsChunked(tensor, nodePath, compressed, errorBound)
+    );
+    elementsNode->get("chunkLens") = New<ArrayNode<Natural<>>>(
+      chunkLens, SOURCE_LOCATION
+    );
+    if (errorBound > 0) elementsNode->setValue("errorBound", errorBound);
   } else {
-    elementsNode->setValue("type", std::string("TextFile"));
+    ASSERT_LOCATION(
+      elementsType == "TextFile",
+      "Unsupported elements type \"" + elementsType + "\"",
+      options->sourceLocation
+    );
+    elementsNode->setValue("type", elementsType);
     writeTensorElementsText(tensor, nodePath);
   }
 
@@ -160,7 +482,8 @@ Ptr<MapNode> TensorIo::writeTensor(
 template <typename F, typename TE>
 Ptr<PointerNode<Object>> TensorIo::readTensor(
   const Ptr<MapNode> &node,
-  const std::string &nodePath
+  const std::string &nodePath,
+  const Ptr<MapNode> &options
 ) {
   auto version(node->getValue<Natural<32>>("version"));
   ASSERT_LOCATION(
@@ -171,9 +494,10 @@ Ptr<PointerNode<Object>> TensorIo::readTensor(
   );
   auto elementsNode(node->getMap("elements"));
   auto elementsType(elementsNode->getValue<std::string>("type"));
-  auto elementsBinary(elementsType == "IeeeBinaryFile" ? true : false);
   auto elementsPath(nodePath + ".elements");
   auto sourceLocation(node->sourceLocation);
+  // the elements may still be written in the background
+  awaitWrite(elementsPath);
   auto dimensionsMap(node->getMap("dimensions"));
 
   std::vector<Natural<>> lens;
@@ -182,13 +506,11 @@ Ptr<PointerNode<Object>> TensorIo::readTensor(
     auto dimensionMap(dimensionsMap->getMap(key));
     lens.push_back(dimensionMap->getValue<Natural<>>("length"));
     // get dimension properties, if given
-    if (dimensionMap->isGiven("type")) {
-      dimensions.push_back(
-        TensorIo::getDimension(
-          dimensionsMap->getMap(key)->getValue<std::string>("type")
-        )
-      );
-    }
+    dimensions.push_back(
+      dimensionMap->isGiven("type") ?
+        TensorIo::getDimension(dimensionMap->getValue<std::string>("type")) :
+        nullptr
+    );
   }
 
   // check if tensor is given in block sparse format
@@ -208,49 +530,180 @@ Ptr<PointerNode<Object>> TensorIo::readTensor(
         TensorDimensionPropertyReference dimensionProperty;
         dimensionProperty.dimension = propertyMap->getValue<Natural<>>("dimension");
         auto dimension(dimensions[dimensionProperty.dimension]);
+        ASSERT_LOCATION(
+          dimension,
+          "Non-zero condition refers to dimension " +
+            std::to_string(dimensionProperty.dimension) + " without type",
+          propertyMap->sourceLocation
+        );
         dimensionProperty.property = dimension->properties[
           propertyMap->getValue<std::string>("property")
         ];
         nonZeroCondition->dimensionPropertyReferences.push_back(dimensionProperty);
         ++D;
       }
-      auto tuplesMap(allMap->getMap(key)->getMap("nonZeros"));
-      for (Natural<> i(0); i < tuplesMap->getSize(); ++i) {
-        std::vector<Natural<>> tuple(D);
-        for (Natural<> d(0); d < D; ++d) {
-          tuple[d] = tuplesMap->getMap(i)->getValue<Natural<>>(d);
-        }
-        nonZeroCondition->tuples.push_back(tuple);
+      // tuples are read as one dense array
+      auto tuples(
+        allMap->getMap(key)->getTupleArray<Natural<>>("nonZeros")
+      );
+      auto tuplesCount(tuples->getSize());
+      ASSERT_LOCATION(
+        tuplesCount == 0 || tuples->tupleSize == D,
+        "Expecting " + std::to_string(D) + " indices per non-zero tuple",
+        tuples->sourceLocation
+      );
+      nonZeroCondition->tuples.reserve(tuplesCount);
+      for (Natural<> i(0); i < tuplesCount; ++i) {
+        nonZeroCondition->tuples.push_back(tuples->getTuple(i));
       }
       nonZeroConditions->all.push_back(nonZeroCondition);
     }
   }
 
-  Ptr<Tensor<F,TE>> tensor;
-  if (elementsBinary) {
-    tensor = readTensorElementsBinary<F,TE>(
-      elementsPath, lens, nonZeroConditions, sourceLocation
+  // range to read, by default the entire tensor
+  std::vector<Natural<>> begins(lens.size()), ends(lens);
+  for (auto range: {std::make_pair("begins", &begins), {"ends", &ends}}) {
+    if (!options->isGiven(range.first)) continue;
+    auto rangeNode(options->getArray<Natural<>>(range.first));
+    ASSERT_LOCATION(
+      rangeNode->getSize() == lens.size(),
+      std::string("Expecting ") + range.first + " for each of the " +
+        std::to_string(lens.size()) + " dimensions of the tensor " + nodePath,
+      options->sourceLocation
     );
-  } else {
-    tensor = readTensorElementsText<F,TE>(
-      elementsPath, lens, nonZeroConditions, sourceLocation
+    *range.second = rangeNode->values;
+  }
+  for (Natural<> d(0); d < lens.size(); ++d) {
+    ASSERT_LOCATION(
+      begins[d] <= ends[d] && ends[d] <= lens[d],
+      "Invalid range in dimension " + std::to_string(d) +
+        " of the tensor " + nodePath,
+      options->sourceLocation
     );
   }
+
+  // create tensor of the requested range, shape and meta data are
+  // available before its elements are read
+  std::vector<Natural<>> rangeLens(lens.size());
+  for (Natural<> d(0); d < lens.size(); ++d) {
+    rangeLens[d] = ends[d] - begins[d];
+  }
+  auto tensor( Tcc<TE>::template tensor<F>(rangeLens, elementsPath) );
+  // dimension properties and non-zero conditions refer to the range
   tensor->dimensions = dimensions;
+  tensor->nonZeroConditions = nonZeroConditions;
+  if (rangeLens != lens) {
+    restrictToRange(
+      tensor->dimensions, tensor->nonZeroConditions, lens, begins, ends
+    );
+  }
   tensor->getUnit() = node->getValue<Real<>>("unit");
   if (node->isGiven("metaData")) {
     tensor->metaData = node->getMap("metaData");
   }
 
+  // the working directory may change until deferred reads
+  auto absolutePath(getAbsolutePath(elementsPath));
+  // identify the file and range read, e.g. for caching derived results
+  auto identity(getFileIdentity(absolutePath));
+  std::stringstream readIdentity;
+  readIdentity << absolutePath << ":" << identity << ":";
+  for (Natural<> d(0); d < lens.size(); ++d) {
+    readIdentity << (d > 0 ? "," : "") << begins[d] << "-" << ends[d];
+  }
+  readIdentities[tensor.get()] = std::make_pair(tensor, readIdentity.str());
+  auto load(
+    [
+      elementsType, absolutePath, lens, begins, ends, nonZeroConditions,
+      sourceLocation
+    ](
+      const Ptr<Tensor<F,TE>> &tensor
+    ) {
+      readTensorElements(
+        tensor, elementsType, absolutePath, lens, begins, ends,
+        nonZeroConditions, sourceLocation
+      );
+    }
+  );
+  if (options->getValue<bool>("lazy", false)) {
+    // defer reading until the elements are first needed, provided
+    // the file has not been rewritten until then
+    OUT() << "Deferring reading of " << elementsPath <<
+      " until first use" << std::endl;
+    tensor->setLoader(
+      [load, absolutePath, identity, sourceLocation](
+        const Ptr<Tensor<F,TE>> &tensor
+      ) {
+        awaitWrite(absolutePath);
+        ASSERT_LOCATION(
+          getFileIdentity(absolutePath) == identity,
+          "File " + absolutePath + " changed since it was read lazily",
+          sourceLocation
+        );
+        load(tensor);
+      }
+    );
+  } else {
+    load(tensor);
+  }
+
   return New<PointerNode<Object>>(tensor, SourceLocation(nodePath,1));
 }
 
+template <typename F, typename TE>
+void TensorIo::readTensorElements(
+  const Ptr<Tensor<F,TE>> &tensor,
+  const std::string &elementsType,
+  const std::string &fileName,
+  const std::vector<Natural<>> &lens,
+  const std::vector<Natural<>> &begins,
+  const std::vector<Natural<>> &ends,
+  const Ptr<TensorNonZeroConditions> &nonZeroConditions,
+  const SourceLocation &sourceLocation
+) {
+  if (
+    elementsType == "ChunkedBinaryFile" ||
+    elementsType == "CompressedBinaryFile"
+  ) {
+    // only the chunks intersecting the requested range are read
+    readTensorElementsChunked(
+      tensor, fileName, begins, elementsType == "CompressedBinaryFile",
+      sourceLocation
+    );
+    return;
+  }
+
+  // other formats have to be read entirely before slicing
+  auto isRanged(tensor->getLens() != lens);
+  auto entireTensor(tensor);
+  if (isRanged) {
+    WARNING_LOCATION(sourceLocation) << "Reading entire tensor " << fileName
+      << " of elements type " << elementsType << " to take a slice. "
+      << "Consider using ChunkedBinaryFile." << std::endl;
+    entireTensor = Tcc<TE>::template tensor<F>(lens, fileName);
+    entireTensor->nonZeroConditions = nonZeroConditions;
+  }
+  if (elementsType == "IeeeBinaryFile") {
+    readTensorElementsBinary(entireTensor, fileName, sourceLocation);
+  } else {
+    readTensorElementsText(entireTensor, fileName, sourceLocation);
+  }
+  if (isRanged) {
+    std::string index("");
+    for (Natural<> d(0); d < lens.size(); ++d) {
+      index += ('a' + d);
+    }
+    COMPILE(
+      (*tensor)[index] <<= (*(*entireTensor)(begins,ends))[index]
+    )->execute();
+  }
+}
+
 template <typename F, typename TE>
 void TensorIo::writeTensorElementsText(
   const Ptr<Tensor<F,TE>> &tensor, const std::string &nodePath
 ) {
-  // TODO: query max buffer size for tensor write from tensor engine
-  constexpr Natural<> MAX_BUFFER_SIZE(32*1024*1024);
+  const Natural<> MAX_BUFFER_SIZE(getMaxBufferSize(sizeof(F)));
   std::string elementsPath(nodePath + ".elements");
   std::ofstream stream(elementsPath);
   if (stream.fail()) {
@@ -318,6 +771,8 @@ void TensorIo::writeTensorElementsBinary(
     !mpiError, std::string("Failed to open file '") + elementsPath + "'",
     SOURCE_LOCATION
   )
+  // discard the tail of a previous, longer file
+  MPI_File_set_size(file, 0);
 
   OUT() << "Writing to binary file " << elementsPath << std::endl;
   if (Cc4s::dryRun) return;
@@ -332,14 +787,197 @@ void TensorIo::writeTensorElementsBinary(
 }
 
 template <typename F, typename TE>
-Ptr<Tensor<F,TE>> TensorIo::readTensorElementsText(
+void TensorIo::writeTensorElementsBinaryAsync(
+  const Ptr<Tensor<F,TE>> &tensor, const std::string &nodePath
+) {
+  std::string elementsPath(nodePath + ".elements");
+  // a previous write to the same file must be finished first
+  awaitWrite(elementsPath);
+  MPI_File file;
+  int mpiError(
+    MPI_File_open(
+      Cc4s::world->getComm(), elementsPath.c_str(),
+      MPI_MODE_CREATE | MPI_MODE_WRONLY,
+      MPI_INFO_NULL, &file
+    )
+  );
+  ASSERT_LOCATION(
+    !mpiError, std::string("Failed to open file '") + elementsPath + "'",
+    SOURCE_LOCATION
+  )
+  // discard the tail of a previous, longer file
+  MPI_File_set_size(file, 0);
+
+  OUT() << "Writing to binary file " << elementsPath << " in background" <<
+    std::endl;
+  if (Cc4s::dryRun) {
+    MPI_File_close(&file);
+    return;
+  }
+
+  // snapshot a contiguous range of the global elements on each rank,
+  // later modifications of the tensor do not affect the written data
+  auto rank(Cc4s::world->getRank());
+  auto processes(Cc4s::world->getProcesses());
+  auto elementsCount(tensor->getElementsCount());
+  Natural<> first(elementsCount * rank / processes);
+  Natural<> last(elementsCount * (rank+1) / processes);
+  PendingWrite pendingWrite;
+  pendingWrite.file = file;
+  pendingWrite.buffer.resize(sizeof(F) * (last-first));
+  {
+    std::vector<Natural<>> indices(last-first);
+    for (Natural<> i(0); i < indices.size(); ++i) indices[i] = first+i;
+    tensor->read(
+      indices.size(), indices.data(),
+      reinterpret_cast<F *>(pendingWrite.buffer.data())
+    );
+  }
+
+  // issue nonblocking writes, each at most 1GB to fit MPI counts
+  constexpr Natural<> MAX_REQUEST_SIZE(1024*1024*1024);
+  auto &buffer(pendingWrite.buffer);
+  for (
+    Natural<> offset(0); offset < buffer.size(); offset += MAX_REQUEST_SIZE
+  ) {
+    Natural<> size(std::min(buffer.size() - offset, MAX_REQUEST_SIZE));
+    MPI_Request request;
+    MPI_File_iwrite_at(
+      file, sizeof(F)*first + offset, buffer.data() + offset, size, MPI_BYTE,
+      &request
+    );
+    pendingWrite.requests.push_back(request);
+  }
+  // moving the buffer keeps its data in place for the pending requests
+  pendingWrites[getAbsolutePath(elementsPath)] = std::move(pendingWrite);
+}
+
+template <typename F, typename TE>
+std::vector<Natural<>> TensorIo::writeTensorElementsChunked(
+  const Ptr<Tensor<F,TE>> &tensor, const std::string &nodePath,
+  const bool compressed, const Real<> errorBound
+) {
+  std::string elementsPath(nodePath + ".elements");
+  TensorChunks chunks(tensor->lens, sizeof(F), MAX_CHUNK_ELEMENTS);
+  // open the file
+  MPI_File file;
+  int mpiError(
+    MPI_File_open(
+      Cc4s::world->getComm(), elementsPath.c_str(),
+      MPI_MODE_CREATE | MPI_MODE_WRONLY,
+      MPI_INFO_NULL, &file
+    )
+  );
+  ASSERT_LOCATION(
+    !mpiError, std::string("Failed to open file '") + elementsPath + "'",
+    SOURCE_LOCATION
+  )
+  // discard the tail of a previous, longer file
+  MPI_File_set_size(file, 0);
+
+  OUT() << "Writing to " << (compressed ? "compressed" : "chunked") <<
+    " binary file " << elementsPath << std::endl;
+  if (errorBound > 0) {
+    OUT() << "Elements are rounded within an absolute error of " <<
+      errorBound << std::endl;
+  }
+  if (Cc4s::dryRun) {
+    MPI_File_close(&file);
+    return chunks.chunkLens;
+  }
+
+  // distribute chunks round robin over all ranks
+  auto rank(Cc4s::world->getRank());
+  auto processes(Cc4s::world->getProcesses());
+  auto chunksCount(chunks.getChunksCount());
+  std::vector<Natural<>> localChecksums(chunksCount);
+  std::vector<Natural<>> localOffsets(chunksCount), localSizes(chunksCount);
+  std::vector<Natural<>> begins, ends, indices, roundSizes;
+  std::vector<F> values;
+  std::vector<char> encoded;
+  // chunks are written contiguously after the header in order
+  Natural<> offset(chunks.offsets.size() > 0 ? chunks.offsets[0] : 0);
+  for (Natural<> round(0); round*processes < chunksCount; ++round) {
+    Natural<> chunk(round*processes + rank);
+    indices.clear();
+    if (chunk < chunksCount) {
+      // enumerate global indices of chunk elements, first index fastest
+      chunks.getRange(chunk, begins, ends);
+      std::vector<Natural<>> position(begins);
+      do {
+        Natural<> index(0), stride(1);
+        for (Natural<> d(0); d < position.size(); ++d) {
+          index += position[d] * stride;
+          stride *= tensor->lens[d];
+        }
+        indices.push_back(index);
+        Natural<> d(0);
+        while (d < position.size() && ++position[d] == ends[d]) {
+          position[d] = begins[d];
+          ++d;
+        }
+        if (d == position.size()) break;
+      } while (true);
+    }
+    values.resize(indices.size());
+    // all ranks participate in reading from the tensor
+    tensor->read(indices.size(), indices.data(), values.data());
+    auto data(reinterpret_cast<const char *>(values.data()));
+    Natural<> size(sizeof(F) * values.size());
+    if (compressed && chunk < chunksCount) {
+      // compress each chunk independently on the rank owning it
+      auto words(reinterpret_cast<Real<64> *>(values.data()));
+      auto wordsCount(size / sizeof(Real<64>));
+      ByteShuffleCodec::quantize(words, wordsCount, errorBound);
+      encoded = ByteShuffleCodec::encode(words, wordsCount);
+      // store uncompressed if compression does not pay off
+      if (encoded.size() < size) {
+        data = encoded.data();
+        size = encoded.size();
+      }
+    }
+    // offsets of this round's chunks follow from the sizes of all ranks
+    std::vector<Natural<>> localSize(1, size);
+    Cc4s::world->allGather(localSize, roundSizes);
+    for (Natural<> r(0); r < rank; ++r) offset += roundSizes[r];
+    if (chunk < chunksCount) {
+      localOffsets[chunk] = offset;
+      localSizes[chunk] = size;
+      localChecksums[chunk] = TensorChunks::getChecksum(data, size);
+      MPI_File_write_at(
+        file, offset, data, size, MPI_BYTE, MPI_STATUS_IGNORE
+      );
+    }
+    for (Natural<> r(rank); r < processes; ++r) offset += roundSizes[r];
+  }
+
+  // collect chunk index and write header on root
+  Cc4s::world->reduce(localOffsets, chunks.offsets);
+  Cc4s::world->reduce(localSizes, chunks.sizes);
+  Cc4s::world->reduce(localChecksums, chunks.checksums);
+  if (rank == 0) {
+    auto header(chunks.serialize());
+    MPI_File_write_at(
+      file, 0, header.data(), header.size()*sizeof(Natural<>), MPI_BYTE,
+      MPI_STATUS_IGNORE
+    );
+  }
+  LOG() << "Written " << offset << " bytes for " <<
+    sizeof(F)*tensor->getElementsCount() << " bytes of elements in " <<
+    chunksCount << " chunks to binary file " << elementsPath << std::endl;
+
+  // done
+  MPI_File_close(&file);
+  return chunks.chunkLens;
+}
+
+template <typename F, typename TE>
+void TensorIo::readTensorElementsText(
+  const Ptr<Tensor<F,TE>> &tensor,
   const std::string &fileName,
-  const std::vector<Natural<>> &lens,
-  const Ptr<TensorNonZeroConditions> &nonZeroConditions,
   const SourceLocation &sourceLocation
 ) {
-  // TODO: query max buffer size for tensor write from tensor engine
-  constexpr Natural<> MAX_BUFFER_SIZE(32*1024*1024);
+  const Natural<> MAX_BUFFER_SIZE(getMaxBufferSize(sizeof(F)));
   std::ifstream stream(fileName.c_str());
   if (stream.fail()) {
     std::stringstream explanation;
@@ -348,11 +986,10 @@ Ptr<Tensor<F,TE>> TensorIo::readTensorElementsText(
   }
   Scanner scanner(&stream);
 
-  // create tensor
-  auto tensor( Tcc<TE>::template tensor<F>(lens, fileName) );
-  tensor->nonZeroConditions = nonZeroConditions;
+  auto &lens(tensor->lens);
+  auto nonZeroConditions(tensor->nonZeroConditions);
   OUT() << "Reading from text file " << fileName << std::endl;
-  if (Cc4s::dryRun) return tensor;
+  if (Cc4s::dryRun) return;
 
   LOG() << "#non-zero conditions: " << nonZeroConditions->all.size() << std::endl;
   TensorNonZeroBlockIterator blockIterator(nonZeroConditions);
@@ -390,23 +1027,20 @@ Ptr<Tensor<F,TE>> TensorIo::readTensorElementsText(
     ++blockIterator;
   }
 
-  return tensor;
 }
 
 template <typename F, typename TE>
-Ptr<Tensor<F,TE>> TensorIo::readTensorElementsBinary(
+void TensorIo::readTensorElementsBinary(
+  const Ptr<Tensor<F,TE>> &tensor,
   const std::string &fileName,
-  const std::vector<Natural<>> &lens,
-  const Ptr<TensorNonZeroConditions> &nonZeroConditions,
   const SourceLocation &sourceLocation
 ) {
-  if (nonZeroConditions->all.size() == 0) {
-    return readTensorElementsBinaryDense<F,TE>(
-      fileName, lens, nonZeroConditions, sourceLocation
-    );
+  if (tensor->nonZeroConditions->all.size() == 0) {
+    readTensorElementsBinaryDense<F,TE>(tensor, fileName, sourceLocation);
+    return;
   }
 
-  constexpr Natural<> MAX_BUFFER_SIZE(32*1024*1024);
+  const Natural<> MAX_BUFFER_SIZE(getMaxBufferSize(sizeof(F)));
   std::ifstream stream(fileName.c_str());
   if (stream.fail()) {
     std::stringstream explanation;
@@ -414,11 +1048,10 @@ Ptr<Tensor<F,TE>> TensorIo::readTensorElementsBinary(
     throw New<Exception>(explanation.str(), sourceLocation);
   }
 
-  // create dense result tensor
-  auto tensor( Tcc<TE>::template tensor<F>(lens, fileName) );
-  tensor->nonZeroConditions = nonZeroConditions;
+  auto &lens(tensor->lens);
+  auto nonZeroConditions(tensor->nonZeroConditions);
   OUT() << "Reading from binary file " << fileName << std::endl;
-  if (Cc4s::dryRun) return tensor;
+  if (Cc4s::dryRun) return;
 
   LOG() << "#non-zero conditions: " << nonZeroConditions->all.size() << std::endl;
   TensorNonZeroBlockIterator blockIterator(nonZeroConditions);
@@ -460,14 +1093,12 @@ Ptr<Tensor<F,TE>> TensorIo::readTensorElementsBinary(
     ++blockIterator;
   }
 
-  return tensor;
 }
 
 template <typename F, typename TE>
-Ptr<Tensor<F,TE>> TensorIo::readTensorElementsBinaryDense(
+void TensorIo::readTensorElementsBinaryDense(
+  const Ptr<Tensor<F,TE>> &tensor,
   const std::string &fileName,
-  const std::vector<Natural<>> &lens,
-  const Ptr<TensorNonZeroConditions> &nonZeroConditions,
   const SourceLocation &sourceLocation
 ) {
   // open the file
@@ -483,11 +1114,8 @@ Ptr<Tensor<F,TE>> TensorIo::readTensorElementsBinaryDense(
     sourceLocation
   )
 
-  // create tensor
-  auto tensor( Tcc<TE>::template tensor<F>(lens, fileName) );
-
   OUT() << "Reading from binary file " << fileName << std::endl;
-  if (Cc4s::dryRun) return tensor;
+  if (Cc4s::dryRun) return;
   // write tensor elements with values from file
   tensor->writeFromFile(file);
   LOG() << "Read " << sizeof(F)*tensor->getElementsCount() <<
@@ -495,6 +1123,158 @@ Ptr<Tensor<F,TE>> TensorIo::readTensorElementsBinaryDense(
 
   // done
   MPI_File_close(&file);
-  return tensor;
 }
 
+
+template <typename F, typename TE>
+void TensorIo::readTensorElementsChunked(
+  const Ptr<Tensor<F,TE>> &tensor,
+  const std::string &fileName,
+  const std::vector<Natural<>> &begins,
+  const bool compressed,
+  const SourceLocation &sourceLocation
+) {
+  // open the file
+  MPI_File file;
+  int mpiError(
+    MPI_File_open(
+      Cc4s::world->getComm(), fileName.c_str(), MPI_MODE_RDONLY,
+      MPI_INFO_NULL, &file
+    )
+  );
+  ASSERT_LOCATION(
+    !mpiError, std::string("Failed to open file '") + fileName + "'",
+    sourceLocation
+  )
+
+  // the tensor has the shape of the requested range
+  auto &lens(tensor->lens);
+  std::vector<Natural<>> ends(begins.size());
+  for (Natural<> d(0); d < lens.size(); ++d) ends[d] = begins[d] + lens[d];
+
+  OUT() << "Reading from chunked binary file " << fileName << std::endl;
+  if (Cc4s::dryRun) {
+    MPI_File_close(&file);
+    return;
+  }
+
+  // read header on root and broadcast it to all others
+  std::vector<Natural<>> headerSize(1);
+  std::vector<Natural<>> header;
+  if (Cc4s::world->getRank() == 0) {
+    header.resize(TensorChunks::getHeaderWords(begins.size(), 0));
+    MPI_File_read_at(
+      file, 0, header.data(), header.size()*sizeof(Natural<>), MPI_BYTE,
+      MPI_STATUS_IGNORE
+    );
+    // number of chunks is the last word of the fixed part
+    headerSize[0] = header[0] == TensorChunks::MAGIC ?
+      TensorChunks::getHeaderWords(begins.size(), header.back()) :
+      header.size();
+  }
+  Cc4s::world->broadcast(headerSize);
+  header.resize(headerSize[0]);
+  if (Cc4s::world->getRank() == 0) {
+    MPI_File_read_at(
+      file, 0, header.data(), header.size()*sizeof(Natural<>), MPI_BYTE,
+      MPI_STATUS_IGNORE
+    );
+  }
+  Cc4s::world->broadcast(header);
+  auto chunks(TensorChunks::deserialize(header, sourceLocation));
+  ASSERT_LOCATION(
+    chunks.elementSize == sizeof(F) && chunks.lens.size() == lens.size(),
+    "Chunked elements file " + fileName + " does not match tensor type",
+    sourceLocation
+  );
+
+  // distribute intersecting chunks round robin over all ranks
+  auto rank(Cc4s::world->getRank());
+  auto processes(Cc4s::world->getProcesses());
+  auto intersectingChunks(chunks.getIntersectingChunks(begins, ends));
+  std::vector<Natural<>> chunkBegins, chunkEnds, indices;
+  std::vector<F> chunkValues, values;
+  std::vector<char> encoded;
+  Natural<> readBytes(0);
+  for (
+    Natural<> round(0);
+    round*processes < intersectingChunks.size();
+    ++round
+  ) {
+    indices.clear();
+    values.clear();
+    if (round*processes + rank < intersectingChunks.size()) {
+      auto chunk(intersectingChunks[round*processes + rank]);
+      chunks.getRange(chunk, chunkBegins, chunkEnds);
+      Natural<> chunkElementsCount(1);
+      for (Natural<> d(0); d < lens.size(); ++d) {
+        chunkElementsCount *= chunkEnds[d] - chunkBegins[d];
+      }
+      chunkValues.resize(chunkElementsCount);
+      auto rawSize(sizeof(F) * chunkElementsCount);
+      // chunks not smaller than their elements are stored uncompressed
+      auto isEncoded(compressed && chunks.sizes[chunk] < rawSize);
+      encoded.resize(isEncoded ? chunks.sizes[chunk] : 0);
+      auto data(
+        isEncoded ?
+          encoded.data() : reinterpret_cast<char *>(chunkValues.data())
+      );
+      ASSERT_LOCATION(
+        isEncoded || chunks.sizes[chunk] == rawSize,
+        "Unexpected size of chunk " + std::to_string(chunk) +
+          " in file " + fileName,
+        sourceLocation
+      );
+      MPI_File_read_at(
+        file, chunks.offsets[chunk], data, chunks.sizes[chunk], MPI_BYTE,
+        MPI_STATUS_IGNORE
+      );
+      readBytes += chunks.sizes[chunk];
+      if (
+        TensorChunks::getChecksum(data, chunks.sizes[chunk]) !=
+          chunks.checksums[chunk]
+      ) {
+        std::stringstream explanation;
+        explanation << "Checksum mismatch in chunk " << chunk <<
+          " of file " << fileName;
+        throw New<Exception>(explanation.str(), sourceLocation);
+      }
+      if (isEncoded) {
+        ByteShuffleCodec::decode(
+          encoded, reinterpret_cast<Real<64> *>(chunkValues.data()),
+          rawSize / sizeof(Real<64>), sourceLocation
+        );
+      }
+      // select chunk elements within range, first index fastest
+      std::vector<Natural<>> position(chunkBegins);
+      for (auto value: chunkValues) {
+        bool inRange(true);
+        Natural<> index(0), stride(1);
+        for (Natural<> d(0); d < position.size(); ++d) {
+          inRange &= begins[d] <= position[d] && position[d] < ends[d];
+          index += (position[d] - begins[d]) * stride;
+          stride *= lens[d];
+        }
+        if (inRange) {
+          indices.push_back(index);
+          values.push_back(value);
+        }
+        Natural<> d(0);
+        while (d < position.size() && ++position[d] == chunkEnds[d]) {
+          position[d] = chunkBegins[d];
+          ++d;
+        }
+      }
+    }
+    // all ranks participate in writing to the tensor
+    tensor->write(indices.size(), indices.data(), values.data());
+  }
+  Natural<> totalReadBytes;
+  Cc4s::world->reduce(readBytes, totalReadBytes);
+  LOG() << "Read " << totalReadBytes << " bytes in " <<
+    intersectingChunks.size() << " of " << chunks.getChunksCount() <<
+    " chunks from binary file " << fileName << std::endl;
+
+  // done
+  MPI_File_close(&file);
+}
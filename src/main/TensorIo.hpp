@@ -23,11 +23,101 @@
 #include <Reader.hpp>
 #include <Scanner.hpp>
 
+#include <map>
+#include <string>
+#include <vector>
+#include <mpi.h>
+
 namespace cc4s {
+  /**
+   * \brief Index of the chunks of a tensor stored in the element type
+   * ChunkedBinaryFile. The tensor is partitioned into hyper-rectangular
+   * chunks of identical shape chunkLens, except at the upper boundaries.
+   * Chunks as well as elements within each chunk are enumerated with
+   * the first index running fastest.
+   * In the element type CompressedBinaryFile each chunk is compressed
+   * individually and the chunk sizes vary accordingly.
+   * The index is stored as header of the elements file, see
+   * reference/chunked_tensor_file_format.txt.
+   **/
+  class TensorChunks {
+  public:
+    TensorChunks() {
+    }
+
+    /**
+     * \brief Creates the chunk index for a tensor of the given shape.
+     * Chunks are made as large as possible but no larger than
+     * maxChunkElements by successively halving the longest chunk dimension.
+     * Offsets and sizes assume uncompressed chunks following the header.
+     **/
+    TensorChunks(
+      const std::vector<Natural<>> &lens_,
+      const Natural<> elementSize_,
+      const Natural<> maxChunkElements
+    );
+
+    /**
+     * \brief Number of 64 bit words of the header for a tensor of the given
+     * order and number of chunks.
+     **/
+    static Natural<> getHeaderWords(
+      const Natural<> order, const Natural<> chunksCount
+    ) {
+      return 4 + 2*order + 3*chunksCount;
+    }
+
+    Natural<> getChunksCount() const {
+      return offsets.size();
+    }
+
+    /**
+     * \brief Begin and end indices of the given chunk in each dimension.
+     **/
+    void getRange(
+      const Natural<> chunk,
+      std::vector<Natural<>> &begins,
+      std::vector<Natural<>> &ends
+    ) const;
+
+    /**
+     * \brief Indices of all chunks intersecting the hyper-rectangle
+     * [begins,ends).
+     **/
+    std::vector<Natural<>> getIntersectingChunks(
+      const std::vector<Natural<>> &begins,
+      const std::vector<Natural<>> &ends
+    ) const;
+
+    std::vector<Natural<>> serialize() const;
+    static TensorChunks deserialize(
+      const std::vector<Natural<>> &header,
+      const SourceLocation &sourceLocation
+    );
+
+    /**
+     * \brief FNV-1a hash of the given bytes used as chunk checksum.
+     **/
+    static Natural<> getChecksum(const char *data, const Natural<> size);
+
+    std::vector<Natural<>> lens, chunkLens;
+    Natural<> elementSize;
+    std::vector<Natural<>> offsets, sizes, checksums;
+
+    static const Natural<> MAGIC;
+  };
+
   class TensorIo {
   public:
     static Ptr<TensorDimension> getDimension(const std::string &name);
 
+    /**
+     * \brief Maximum number of elements of the given size buffered on a
+     * single rank together with their indices when reading or writing
+     * elements sequentially. It is derived from Cc4s::getMemoryPerRank.
+     **/
+    static Natural<> getMaxBufferSize(const Natural<> elementSize);
+
     /**
      * \brief Static handler routine for writing nodes of the type
      * PointerNode<TensorExpression<F,TE>>. If the given node is of such a type
@@ -36,16 +126,98 @@ namespace cc4s {
      * load the written tensor again.
      * nullptr is returned if the given node is not a PointerNode containing
      * a tensor pointer.
+     * If async is true in options, binary elements are written in the
+     * background, see awaitWrites.
      **/
     static Ptr<Node> write(
-      const Ptr<Node> &node, const std::string &nodePath, const bool useBinary
+      const Ptr<Node> &node, const std::string &nodePath,
+      const Ptr<MapNode> &options
     );
 
+    /**
+     * \brief Static handler routine for reading tensors from the given
+     * MapNode. If options specifies begins and ends, only the
+     * hyper-rectangle [begins,ends) of the stored tensor is read.
+     * Pending asynchronous writes of the elements are awaited first.
+     * If lazy is true in options, the elements are only read when
+     * the tensor is first evaluated.
+     **/
     static Ptr<Node> read(
-      const Ptr<MapNode> &node, const std::string &nodePath
+      const Ptr<MapNode> &node, const std::string &nodePath,
+      const Ptr<MapNode> &options
     );
 
+    /**
+     * \brief Waits for the completion of the asynchronous write of the given
+     * elements file, if it is still pending. Collective over all ranks.
+     **/
+    static void awaitWrite(const std::string &fileName);
+
+    /**
+     * \brief Waits for the completion of all pending asynchronous writes.
+     * Collective over all ranks.
+     **/
+    static void awaitWrites();
+
+    /**
+     * \brief Returns the absolute elements file, the read range and the
+     * size and modification time of the file at the time of reading of
+     * the given tensor. Returns an empty string if the tensor was not
+     * read from a file.
+     **/
+    static std::string getReadIdentity(const Ptr<Object> &tensor);
+
   protected:
+    /**
+     * \brief Elements file written in the background by nonblocking MPI-IO
+     * from a snapshot of the locally owned contiguous range of elements.
+     **/
+    class PendingWrite {
+    public:
+      MPI_File file;
+      std::vector<MPI_Request> requests;
+      std::vector<char> buffer;
+    };
+
+    /**
+     * \brief Pending asynchronous writes by absolute file name.
+     **/
+    static std::map<std::string, PendingWrite> pendingWrites;
+
+    /**
+     * \brief Identities of the files of tensors read, by weakly
+     * referenced tensor.
+     **/
+    static std::map<
+      const Object *, std::pair<WeakPtr<Object>, std::string>
+    > readIdentities;
+
+    /**
+     * \brief Absolute path of the given file name relative to the
+     * current working directory.
+     **/
+    static std::string getAbsolutePath(const std::string &fileName);
+
+    /**
+     * \brief Size and modification time of the given file as seen by
+     * the root rank, identical on all ranks. Used to detect files that
+     * were rewritten before their deferred read.
+     **/
+    static std::string getFileIdentity(const std::string &fileName);
+
+    /**
+     * \brief Restricts the given dimensions and non-zero conditions of a
+     * tensor with the given lens to the hyper-rectangle [begins,ends).
+     * Restricted dimensions are new objects with shifted property indices.
+     **/
+    static void restrictToRange(
+      std::vector<Ptr<TensorDimension>> &dimensions,
+      Ptr<TensorNonZeroConditions> &nonZeroConditions,
+      const std::vector<Natural<>> &lens,
+      const std::vector<Natural<>> &begins,
+      const std::vector<Natural<>> &ends
+    );
+
     /**
      * \brief Serialization version. Only objects written by
      * a matching serialization version can be read. Increase this version
@@ -53,17 +225,23 @@ namespace cc4s {
      **/
     static const Natural<32> VERSION;
 
+    /**
+     * \brief Maximum number of elements per chunk in ChunkedBinaryFiles.
+     **/
+    static const Natural<> MAX_CHUNK_ELEMENTS;
+
     template <typename F, typename TE>
     static Ptr<MapNode> writeTensor(
       const Ptr<Node> &node,
       const std::string &nodePath,
-      const bool useBinary
+      const Ptr<MapNode> &options
     );
 
     template <typename F, typename TE>
     static Ptr<PointerNode<Object>> readTensor(
       const Ptr<MapNode> &node,
-      const std::string &nodePath
+      const std::string &nodePath,
+      const Ptr<MapNode> &options
     );
 
     template <typename F, typename TE>
@@ -76,27 +254,66 @@ namespace cc4s {
       const Ptr<Tensor<F,TE>> &tensor, const std::string &nodePath
     );
 
+    /**
+     * \brief Writes the elements in the same layout as
+     * writeTensorElementsBinary. Only the snapshot of the elements is
+     * taken collectively, writing it to disk overlaps with subsequent work.
+     **/
     template <typename F, typename TE>
-    static Ptr<Tensor<F,TE>> readTensorElementsText(
+    static void writeTensorElementsBinaryAsync(
+      const Ptr<Tensor<F,TE>> &tensor, const std::string &nodePath
+    );
+
+    template <typename F, typename TE>
+    static std::vector<Natural<>> writeTensorElementsChunked(
+      const Ptr<Tensor<F,TE>> &tensor, const std::string &nodePath,
+      const bool compressed, const Real<> errorBound
+    );
+
+    /**
+     * \brief Reads the hyper-rectangle [begins,ends) of the elements of the
+     * stored tensor with the given lens and non-zero conditions
+     * into the given tensor.
+     **/
+    template <typename F, typename TE>
+    static void readTensorElements(
+      const Ptr<Tensor<F,TE>> &tensor,
+      const std::string &elementsType,
       const std::string &fileName,
-      const std::vector<size_t> &lens,
+      const std::vector<Natural<>> &lens,
+      const std::vector<Natural<>> &begins,
+      const std::vector<Natural<>> &ends,
       const Ptr<TensorNonZeroConditions> &nonZeroConditions,
       const SourceLocation &sourceLocation
     );
 
     template <typename F, typename TE>
-    static Ptr<Tensor<F,TE>> readTensorElementsBinary(
+    static void readTensorElementsText(
+      const Ptr<Tensor<F,TE>> &tensor,
       const std::string &fileName,
-      const std::vector<size_t> &lens,
-      const Ptr<TensorNonZeroConditions> &nonZeroConditions,
       const SourceLocation &sourceLocation
     );
 
     template <typename F, typename TE>
-    static Ptr<Tensor<F,TE>> readTensorElementsBinaryDense(
+    static void readTensorElementsBinary(
+      const Ptr<Tensor<F,TE>> &tensor,
       const std::string &fileName,
-      const std::vector<size_t> &lens,
-      const Ptr<TensorNonZeroConditions> &nonZeroConditions,
+      const SourceLocation &sourceLocation
+    );
+
+    template <typename F, typename TE>
+    static void readTensorElementsBinaryDense(
+      const Ptr<Tensor<F,TE>> &tensor,
+      const std::string &fileName,
+      const SourceLocation &sourceLocation
+    );
+
+    template <typename F, typename TE>
+    static void readTensorElementsChunked(
+      const Ptr<Tensor<F,TE>> &tensor,
+      const std::string &fileName,
+      const std::vector<Natural<>> &begins,
+      const bool compressed,
       const SourceLocation &sourceLocation
     );
 
@@ -201,6 +201,23 @@ namespace cc4s {
       return *this;
     }
 
+    /**
+     * \brief Adds the scalar multiple s of each component of a to the
+     * respective component of this TensorSet.
+     **/
+    TensorSet &axpy(const F s, const TensorSet &a) {
+      ASSERT(isCompatibleTo(a), "Incompatible TensorSets");
+      for (auto component: components) {
+        auto key(component.first);
+        auto tensorExpression(component.second);
+        auto indices(generateIndices(key));
+        COMPILE(
+          (*tensorExpression)[indices] += s * (*a.get(key))[indices]
+        )->execute();
+      }
+      return *this;
+    }
+
     /**
      * \brief Returns the inner product of this ket-TensorSet with the
      * given ket-TensorSet a. The elements of this TensorSet are conjugated
@@ -223,6 +240,141 @@ namespace cc4s {
       return result->read();
     }
 
+    /**
+     * \brief Returns the inner products of this ket-TensorSet with each
+     * of the given ket-TensorSets. Each rank sums the products of its
+     * local elements of this TensorSet with the local elements of the
+     * given ones into one buffer, which is then summed over all ranks
+     * in a single reduction. Only given TensorSets distributed
+     * differently on any rank are read collectively with a second
+     * reduction.
+     **/
+    std::vector<F> dot(const std::vector<Ptr<TensorSet>> &a) const {
+      std::vector<F> values(a.size());
+      if (a.size() == 0) return values;
+      for (Natural<> k(0); k < a.size(); ++k) {
+        ASSERT(isCompatibleTo(*a[k]), "Incompatible TensorSets");
+      }
+      // second half counts the components distributed differently
+      std::vector<F> localValues(2*a.size(), F(0)), reducedValues;
+      std::vector<size_t> braIndices, ketIndices;
+      std::vector<F> braValues, ketValues;
+      for (auto component: components) {
+        auto key(component.first);
+        auto bra(component.second->evaluate());
+        bra->readLocal(braIndices, braValues);
+        for (Natural<> k(0); k < a.size(); ++k) {
+          a[k]->get(key)->evaluate()->readLocal(ketIndices, ketValues);
+          if (ketIndices != braIndices) {
+            localValues[a.size()+k] += F(1);
+            continue;
+          }
+          F localValue(0);
+          for (Natural<> i(0); i < braIndices.size(); ++i) {
+            localValue += cc4s::conj(braValues[i]) * ketValues[i];
+          }
+          localValues[k] += localValue;
+        }
+        Operation<TE>::addFloatingPointOperations(
+          a.size() * bra->getElementsCount() * (
+            TensorOperationTraits<F>::getFlopsPerMultiplication() +
+            TensorOperationTraits<F>::getFlopsPerAddition()
+          )
+        );
+      }
+      Cc4s::world->allReduce(localValues, reducedValues);
+      std::vector<Natural<>> misplaced;
+      for (Natural<> k(0); k < a.size(); ++k) {
+        values[k] = reducedValues[k];
+        if (reducedValues[a.size()+k] != F(0)) misplaced.push_back(k);
+      }
+      if (misplaced.size() == 0) return values;
+      // fall back to reading the bra's indices of the misplaced kets
+      localValues.assign(misplaced.size(), F(0));
+      for (auto component: components) {
+        auto key(component.first);
+        component.second->evaluate()->readLocal(braIndices, braValues);
+        ketValues.resize(braIndices.size());
+        for (Natural<> m(0); m < misplaced.size(); ++m) {
+          a[misplaced[m]]->get(key)->evaluate()->read(
+            braIndices.size(), braIndices.data(), ketValues.data()
+          );
+          for (Natural<> i(0); i < braIndices.size(); ++i) {
+            localValues[m] += cc4s::conj(braValues[i]) * ketValues[i];
+          }
+        }
+      }
+      Cc4s::world->allReduce(localValues, reducedValues);
+      for (Natural<> m(0); m < misplaced.size(); ++m) {
+        values[misplaced[m]] = reducedValues[m];
+      }
+      return values;
+    }
+
+    /**
+     * \brief Returns the linear combination of the given TensorSets
+     * with the given coefficients. Each component of the result is
+     * written by a single compiled sequence without copying or zeroing
+     * it beforehand.
+     **/
+    static Ptr<TensorSet> linearCombination(
+      const std::vector<F> &coefficients, const std::vector<Ptr<TensorSet>> &a
+    ) {
+      ASSERT(
+        coefficients.size() == a.size() && a.size() > 0,
+        "Expecting one coefficient for each of at least one TensorSet"
+      );
+      for (Natural<> k(1); k < a.size(); ++k) {
+        ASSERT(a[0]->isCompatibleTo(*a[k]), "Incompatible TensorSets");
+        for (auto component: a[0]->components) {
+          auto other(a[k]->components.find(component.first));
+          ASSERT(
+            other != a[k]->components.end() && other->second,
+            "Missing component " + component.first + " in TensorSet"
+          );
+          // shapes are only compared if both are already known
+          auto &lens(component.second->inspect()->getLens());
+          auto &otherLens(other->second->inspect()->getLens());
+          ASSERT(
+            lens.size() == 0 || otherLens.size() == 0 || lens == otherLens,
+            "Incompatible shapes of component " + component.first
+          );
+        }
+      }
+      auto result(New<TensorSet>());
+      for (auto component: a[0]->components) {
+        auto key(component.first);
+        auto source(component.second->inspect());
+        auto indices(result->generateIndices(source->getLens().size()));
+        auto target(Tcc<TE>::template tensor<F>(source->getName()));
+        if (a.size() == 1) {
+          COMPILE(
+            (*target)[indices] <<= coefficients[0] * (*source)[indices]
+          )->execute();
+        } else {
+          auto sequence(
+            (
+              (*target)[indices] <<= coefficients[0] * (*source)[indices],
+              (*target)[indices] += coefficients[1] * (*a[1]->get(key))[indices]
+            )
+          );
+          for (Natural<> k(2); k < a.size(); ++k) {
+            sequence = (
+              sequence,
+              (*target)[indices] +=
+                coefficients[k] * (*a[k]->get(key))[indices]
+            );
+          }
+          COMPILE(sequence)->execute();
+        }
+        // transfer dimension info and meta-data as in copyComponents
+        target->dimensions = source->dimensions;
+        target->getMetaData() = source->getMetaData();
+        result->components[key] = target;
+      }
+      return result;
+    }
+
     /**
      * \brief Get the number of component tensors of this TensorSet.
      */
@@ -267,7 +419,8 @@ namespace cc4s {
 
   public:
     static Ptr<Node> write(
-      const Ptr<Node> &node, const std::string &nodePath, const bool useBinary
+      const Ptr<Node> &node, const std::string &nodePath,
+      const Ptr<MapNode> &options
     ) {
       auto pointerNode(node->toPtr<AtomicNode<Ptr<Object>>>());
       if (!pointerNode) return nullptr;
@@ -285,7 +438,7 @@ namespace cc4s {
           TensorIo::write(
             tensorNode,
             componentsNodePath + "." + component.first,
-            useBinary
+            options
           )
         );
         componentsNode->get(component.first) = componentNode;
@@ -296,7 +449,8 @@ namespace cc4s {
     }
 
     static Ptr<Node> read(
-      const Ptr<MapNode> &node, const std::string &nodePath
+      const Ptr<MapNode> &node, const std::string &nodePath,
+      const Ptr<MapNode> &options
     ) {
       auto componentsNode(node->getMap("components"));
       auto componentsNodePath(nodePath + ".components");
@@ -305,7 +459,8 @@ namespace cc4s {
         auto tensorNode(
           TensorIo::read(
             componentsNode->getMap(key),
-            componentsNodePath + "." + key
+            componentsNodePath + "." + key,
+            options
           )
         );
         auto pointerNode(tensorNode->toPtr<PointerNode<Object>>());
@@ -325,28 +480,30 @@ namespace cc4s {
   class TensorSetIo {
   public:
     static Ptr<Node> write(
-      const Ptr<Node> &node, const std::string &nodePath, const bool useBinary
+      const Ptr<Node> &node, const std::string &nodePath,
+      const Ptr<MapNode> &options
     ) {
       // multiplex different tensor types
       Ptr<Node> writtenNode;
       if (!Cc4s::dryRun) {
         using TE = DefaultTensorEngine;
-        writtenNode = TensorSet<Real<64>,TE>::write(node, nodePath, useBinary);
+        writtenNode = TensorSet<Real<64>,TE>::write(node, nodePath, options);
         if (writtenNode) return writtenNode;
-        writtenNode = TensorSet<Complex<64>,TE>::write(node, nodePath, useBinary);
+        writtenNode = TensorSet<Complex<64>,TE>::write(node, nodePath, options);
         if (writtenNode) return writtenNode;
       } else {
         using TE = DefaultDryTensorEngine;
-        writtenNode = TensorSet<Real<64>,TE>::write(node, nodePath, useBinary);
+        writtenNode = TensorSet<Real<64>,TE>::write(node, nodePath, options);
         if (writtenNode) return writtenNode;
-        writtenNode = TensorSet<Complex<64>,TE>::write(node, nodePath, useBinary);
+        writtenNode = TensorSet<Complex<64>,TE>::write(node, nodePath, options);
         if (writtenNode) return writtenNode;
       }
       return nullptr;
     }
 
     static Ptr<Node> read(
-      const Ptr<MapNode> &node, const std::string &nodePath
+      const Ptr<MapNode> &node, const std::string &nodePath,
+      const Ptr<MapNode> &options
     ) {
       auto componentsNode(node->getMap("components"));
       // NOTE: assumes at least one component
@@ -358,16 +515,16 @@ namespace cc4s {
       if (!Cc4s::dryRun) {
         using TE = DefaultTensorEngine;
         if (scalarType == TypeTraits<Real<>>::getName()) {
-          return TensorSet<Real<>,TE>::read(node, nodePath);
+          return TensorSet<Real<>,TE>::read(node, nodePath, options);
         } else if (scalarType == TypeTraits<Complex<>>::getName()) {
-          return TensorSet<Complex<>,TE>::read(node, nodePath);
+          return TensorSet<Complex<>,TE>::read(node, nodePath, options);
         }
       } else {
         using TE = DefaultDryTensorEngine;
         if (scalarType == TypeTraits<Real<>>::getName()) {
-          return TensorSet<Real<>,TE>::read(node, nodePath);
+          return TensorSet<Real<>,TE>::read(node, nodePath, options);
         } else if (scalarType == TypeTraits<Complex<>>::getName()) {
-          return TensorSet<Complex<>,TE>::read(node, nodePath);
+          return TensorSet<Complex<>,TE>::read(node, nodePath, options);
         }
       }
       std::stringstream explanation;
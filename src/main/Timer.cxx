@@ -14,6 +14,11 @@
  */
 
 #include <Timer.hpp>
+#include <Cc4s.hpp>
+
+#include <vector>
+#include <limits>
+#include <algorithm>
 
 using namespace cc4s;
 
@@ -35,3 +40,147 @@ Timer::~Timer() {
   Time end(Time::getCurrentRealTime());
   *time += end - start;
 }
+
+TimerRegion::Measurement TimerRegion::root;
+TimerRegion::Measurement *TimerRegion::current(&TimerRegion::root);
+
+/**
+ * \brief Enters the region of the given name nested in the current region.
+ */
+TimerRegion::TimerRegion(
+  const std::string &name
+): measurement(&current->children[name]) {
+  measurement->parent = current;
+  current = measurement;
+  startOperations = Cc4s::getFloatingPointOperations();
+  start = Time::getCurrentRealTime();
+}
+
+/**
+ * \brief Leaves the region adding the elapsed time and operations.
+ */
+TimerRegion::~TimerRegion() {
+  measurement->time += Time::getCurrentRealTime() - start;
+  measurement->operations +=
+    Cc4s::getFloatingPointOperations() - startOperations;
+  ++measurement->calls;
+  current = measurement->parent;
+}
+
+void TimerRegion::collectPaths(
+  const Measurement &measurement, const std::string &path,
+  std::map<std::string, const Measurement *> &paths
+) {
+  for (auto &child: measurement.children) {
+    auto childPath(path.size() > 0 ? path + "/" + child.first : child.first);
+    paths[childPath] = &child.second;
+    collectPaths(child.second, childPath, paths);
+  }
+}
+
+Ptr<MapNode> TimerRegion::getStatistics() {
+  auto world(Cc4s::world);
+  std::map<std::string, const Measurement *> paths;
+  collectPaths(root, "", paths);
+
+  // rank 0 gathers the paths of all ranks, which may differ
+  std::string localPaths;
+  for (auto &path: paths) localPaths += path.first + '\n';
+  std::vector<int> sizes(world->getProcesses()), displacements;
+  int localSize(localPaths.size());
+  MPI_Gather(
+    &localSize, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, world->getComm()
+  );
+  std::string allPaths;
+  if (world->getRank() == 0) {
+    displacements.resize(sizes.size());
+    for (Natural<> r(1); r < sizes.size(); ++r) {
+      displacements[r] = displacements[r-1] + sizes[r-1];
+    }
+    allPaths.resize(displacements.back() + sizes.back());
+  }
+  MPI_Gatherv(
+    &localPaths[0], localSize, MPI_CHAR,
+    &allPaths[0], sizes.data(), displacements.data(), MPI_CHAR,
+    0, world->getComm()
+  );
+  // and broadcasts the union of all paths in order
+  std::string unitedPaths;
+  if (world->getRank() == 0) {
+    std::map<std::string, bool> united;
+    std::stringstream stream(allPaths);
+    std::string path;
+    while (std::getline(stream, path)) united[path] = true;
+    for (auto &path: united) unitedPaths += path.first + '\n';
+  }
+  world->broadcast(unitedPaths);
+  std::vector<std::string> regions;
+  {
+    std::stringstream stream(unitedPaths);
+    std::string path;
+    while (std::getline(stream, path)) regions.push_back(path);
+  }
+
+  // reduce times of ranks having entered the respective region
+  auto count(regions.size());
+  std::vector<Real<>> localMins(count), localMaxs(count), localSums(count);
+  std::vector<Real<>> localOperations(count), localCalls(count);
+  std::vector<Real<>> localRanks(count);
+  for (Natural<> i(0); i < count; ++i) {
+    auto path(paths.find(regions[i]));
+    if (path != paths.end()) {
+      auto seconds(path->second->time.getFractionalSeconds());
+      localMins[i] = localMaxs[i] = localSums[i] = seconds;
+      localOperations[i] = static_cast<Real<>>(path->second->operations);
+      localCalls[i] = path->second->calls;
+      localRanks[i] = 1;
+    } else {
+      localMins[i] = std::numeric_limits<Real<>>::max();
+    }
+  }
+  std::vector<Real<>> mins(count), maxs(count), sums(count);
+  std::vector<Real<>> operations(count), calls(count), ranks(count);
+  auto comm(world->getComm());
+  MPI_Allreduce(
+    localMins.data(), mins.data(), count, MPI_DOUBLE, MPI_MIN, comm
+  );
+  MPI_Allreduce(
+    localMaxs.data(), maxs.data(), count, MPI_DOUBLE, MPI_MAX, comm
+  );
+  MPI_Allreduce(
+    localSums.data(), sums.data(), count, MPI_DOUBLE, MPI_SUM, comm
+  );
+  // operations are counted globally, take the maximum of all ranks
+  MPI_Allreduce(
+    localOperations.data(), operations.data(), count, MPI_DOUBLE, MPI_MAX,
+    comm
+  );
+  MPI_Allreduce(
+    localCalls.data(), calls.data(), count, MPI_DOUBLE, MPI_MAX, comm
+  );
+  MPI_Allreduce(
+    localRanks.data(), ranks.data(), count, MPI_DOUBLE, MPI_SUM, comm
+  );
+
+  auto statistics(New<MapNode>(SOURCE_LOCATION));
+  for (Natural<> i(0); i < count; ++i) {
+    auto average(sums[i] / ranks[i]);
+    auto region(New<MapNode>(SOURCE_LOCATION));
+    region->setValue("calls", static_cast<Natural<>>(calls[i]));
+    region->setValue("ranks", static_cast<Natural<>>(ranks[i]));
+    region->setValue("minRealtime", mins[i]);
+    region->setValue("maxRealtime", maxs[i]);
+    region->setValue("averageRealtime", average);
+    region->setValue("imbalance", average > 0 ? maxs[i] / average : 1.0);
+    region->setValue("floatingPointOperations", operations[i]);
+    region->setValue(
+      "flops", maxs[i] > 0 ? operations[i] / maxs[i] : 0.0
+    );
+    statistics->get(regions[i]) = region;
+  }
+
+  // start over with next measurement
+  root.children.clear();
+  current = &root;
+  return statistics;
+}
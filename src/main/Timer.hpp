@@ -17,6 +17,12 @@
 #define TIMER_DEFINED
 
 #include <Time.hpp>
+#include <Integer.hpp>
+#include <Node.hpp>
+#include <SharedPointer.hpp>
+
+#include <string>
+#include <map>
 
 namespace cc4s {
   /**
@@ -32,6 +38,53 @@ namespace cc4s {
     Time *time;
     Time start;
   };
+
+  /**
+   * \brief Named timing region measuring realtime and floating point
+   * operations of the scope it is created in, e.g.
+   * TimerRegion region("residuum");
+   * Regions created within the scope of another region are nested in it.
+   * Measurements of all instances of a region are accumulated, which is
+   * cheap enough for hot loops. Regions must only be created by the
+   * master thread.
+   */
+  class TimerRegion {
+  public:
+    TimerRegion(const std::string &name);
+    ~TimerRegion();
+
+    /**
+     * \brief Reduces the measurements of all regions over all ranks and
+     * returns, on all ranks, a map containing min, max, average
+     * and imbalance of the realtime of each region by its path.
+     * The measurements are reset afterwards. Must be called collectively.
+     */
+    static Ptr<MapNode> getStatistics();
+
+  protected:
+    class Measurement {
+    public:
+      Measurement(): parent(nullptr), operations(0), calls(0) {
+      }
+      Measurement *parent;
+      std::map<std::string, Measurement> children;
+      Time time;
+      Natural<128> operations;
+      Natural<> calls;
+    };
+
+    static void collectPaths(
+      const Measurement &measurement, const std::string &path,
+      std::map<std::string, const Measurement *> &paths
+    );
+
+    static Measurement root;
+    static Measurement *current;
+
+    Measurement *measurement;
+    Time start;
+    Natural<128> startOperations;
+  };
 }
 
 #endif
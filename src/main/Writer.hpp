@@ -32,9 +32,15 @@ namespace cc4s {
    */
   class Writer {
   public:
+    /**
+     * \brief Creates a writer for the given file name. The given options
+     * are passed on to the type-specific write functions, e.g.
+     * elementsType specifying the format of tensor elements.
+     **/
     Writer(
-      const std::string &fileName_, const bool useBinary_ = false
-    ): fileName(fileName_), useBinary(useBinary_) {
+      const std::string &fileName_,
+      const Ptr<MapNode> &options_ = New<MapNode>(SOURCE_LOCATION)
+    ): fileName(fileName_), options(options_) {
     }
     Ptr<Node> write(const Ptr<Node> &node) {
       // if fileName contains '/' change directory
@@ -71,7 +77,8 @@ namespace cc4s {
 
     typedef std::function<
       Ptr<Node>(
-        const Ptr<Node> &node, const std::string &nodePath, const bool useBinary
+        const Ptr<Node> &node, const std::string &nodePath,
+        const Ptr<MapNode> &options
       )
     > WriteFunction;
     static int registerWriteFunction(
@@ -117,7 +124,7 @@ namespace cc4s {
     ) {
       for (auto writeFunction: writeFunctions) {
         // try type-specific write function
-        auto writtenNode(writeFunction.second(node, nodePath, useBinary));
+        auto writtenNode(writeFunction.second(node, nodePath, options));
         if (writtenNode) {
           // if successful, enter respective type
           auto writtenNodeMap(writtenNode->toPtr<MapNode>());
@@ -130,7 +137,7 @@ namespace cc4s {
     }
 
     std::string fileName;
-    bool useBinary;
+    Ptr<MapNode> options;
   };
 }
 
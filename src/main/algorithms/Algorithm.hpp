@@ -33,6 +33,15 @@ namespace cc4s {
     virtual ~Algorithm();
     virtual std::string getName() = 0;
     virtual Ptr<MapNode> run(const Ptr<MapNode> &arguments) = 0;
+    /**
+     * \brief Whether the output depends on the arguments alone.
+     * Otherwise, e.g. when reading files, objects of the output are
+     * identified by their content rather than by their origin when
+     * caching steps.
+     **/
+    virtual bool isDeterministic() {
+      return true;
+    }
   };
 
   class AlgorithmFactory {
@@ -1,6 +1,7 @@
 #include <memory>
 
 #include <algorithms/CompleteTriples.hpp>
+#include <algorithms/VertexCoulombIntegrals.hpp>
 #include <TensorSet.hpp>
 
 using namespace cc4s;
@@ -10,27 +11,30 @@ template <typename F, typename TE>
 std::shared_ptr<TensorSet<F, TE>>
 cc4s::ct::getCompleteTriples(
   std::shared_ptr<TensorSet<F, TE>> coulombIntegrals,
-  std::shared_ptr<TensorSet<F, TE>> amplitudes
+  std::shared_ptr<TensorSet<F, TE>> amplitudes,
+  std::shared_ptr<TensorSet<F, TE>> coulombVertexFactors
 ) {
 
   auto Tph ( amplitudes->get("ph") );
   auto Tpphh( amplitudes->get("pphh") );
 
-  auto Vpppp(coulombIntegrals->get("pppp"));
   auto Vphph(coulombIntegrals->get("phph"));
   auto Vhhhh(coulombIntegrals->get("hhhh"));
   auto Vhhhp(coulombIntegrals->get("hhhp"));
-  auto Vppph(coulombIntegrals->get("ppph"));
   auto Vhhpp(coulombIntegrals->get("hhpp"));
-  auto Vpphp(coulombIntegrals->get("pphp"));
   auto Vphhh(coulombIntegrals->get("phhh"));
   auto Vhphp(coulombIntegrals->get("hphp"));
   auto Vphhp(coulombIntegrals->get("phhp"));
-  auto Vphpp(coulombIntegrals->get("phpp"));
   auto Vhhph(coulombIntegrals->get("hhph"));
-  auto Vhppp(coulombIntegrals->get("hppp"));
   auto Vhpph(coulombIntegrals->get("hpph"));
   auto Vhphh(coulombIntegrals->get("hphh"));
+  // slices with three or more particle indices are contracted through
+  // the vertex, if its factors are given
+  auto V([&](const std::string &slice, const std::string &indices) {
+    return VertexCoulombIntegrals::getIntegrals<F,TE>(
+      coulombIntegrals, coulombVertexFactors, slice, indices
+    );
+  });
 
   // Piecuch intermediates
   auto pXiajb( Tcc<TE>::template tensor<F>("pXiajb") );
@@ -56,7 +60,7 @@ cc4s::ct::getCompleteTriples(
     (*Xijka)["ijka"] += (1.0) * (*Tph)["fk"] * (*Vhhpp)["ijfa"],
 
     // Build pXaibc (prime X-phpp intermediate)
-    (*pXaibc)["aibc"] <<= (*Vphpp)["aibc"],
+    (*pXaibc)["aibc"] <<= V("phpp", "aibc"),
     (*pXaibc)["aibc"] += (-0.5) * (*Tph)["al"] * (*Vhhpp)["libc"],
 
     // Build Iia (I-hp intermediate)
@@ -89,8 +93,8 @@ cc4s::ct::getCompleteTriples(
     (*dpXiabj)["iabj"] += ( 0.5) * (*Xaibc)["aifb"] * (*Tph)["fj"],
 
     // Build dpIbcek (dp: double prime I-ppph intermediate)
-    (*dpIbcek)["bcek"] <<= (*Vppph)["bcek"],
-    (*dpIbcek)["bcek"] += ( 1.0) * (*Vpppp)["bcef"] * (*Tph)["fk"],
+    (*dpIbcek)["bcek"] <<= V("ppph", "bcek"),
+    (*dpIbcek)["bcek"] += ( 1.0) * V("pppp", "bcef") * (*Tph)["fk"],
     (*dpIbcek)["bcek"] += (-1.0) * (*pXiajb)["lbke"] * (*Tph)["cl"],
     (*dpIbcek)["bcek"] += (-1.0) * (*Tph)["bl"] * (*pXiabj)["lcek"],
     (*dpIbcek)["bcek"] += (-1.0) * (*Iia)["le"] * (*Tpphh)["bclk"],
@@ -178,7 +182,8 @@ double cc4s::ct::getDenominator(
   std::shared_ptr< cc4s::TensorSet< F , TE > >   \
   cc4s::ct::getCompleteTriples< F , TE >( \
     std::shared_ptr<cc4s::TensorSet< F , TE > > coulombIntegrals, \
-    std::shared_ptr<cc4s::TensorSet< F , TE > > amplitudes \
+    std::shared_ptr<cc4s::TensorSet< F , TE > > amplitudes, \
+    std::shared_ptr<cc4s::TensorSet< F , TE > > coulombVertexFactors \
   );
 
 // Dry tensors
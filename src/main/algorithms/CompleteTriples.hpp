@@ -20,11 +20,16 @@ namespace ct {
  *     https://doi.org/10.1016/S0010-4655(02)00598-2
  * 
  */
+/*
+ * If coulombVertexFactors are given, the integral slices with three or more
+ * particle indices are contracted through the Coulomb vertex instead.
+ */
 template <typename F, typename TE>
 std::shared_ptr<TensorSet<F, TE>>
  getCompleteTriples(
   std::shared_ptr<TensorSet<F, TE>> coulombIntegrals,
-  std::shared_ptr<TensorSet<F, TE>> amplitudes
+  std::shared_ptr<TensorSet<F, TE>> amplitudes,
+  std::shared_ptr<TensorSet<F, TE>> coulombVertexFactors = nullptr
 ); 
 
 template <typename F, typename TE>
@@ -23,11 +23,22 @@
 #include <Options.hpp>
 #include <Cc4s.hpp>
 #include <Timer.hpp>
+#include <Reader.hpp>
+#include <Writer.hpp>
+#include <Parser.hpp>
+#include <StepCache.hpp>
+#include <TensorIo.hpp>
 
+#include <fstream>
+#include <cstdio>
+#include <dirent.h>
+#include <sys/stat.h>
 
 #include <array>
 #include <initializer_list>
 #include <iomanip>
+#include <set>
+#include <sstream>
 
 using namespace cc4s;
 
@@ -35,6 +46,7 @@ ALGORITHM_REGISTRAR_DEFINITION(CoupledCluster)
 
 Ptr<MapNode> CoupledCluster::run(const Ptr<MapNode> &arguments_){
   this->arguments = arguments_;
+  recipes.clear();
   // multiplex calls to template methods
   Ptr<MapNode> result;
   if (Cc4s::dryRun) {
@@ -102,6 +114,31 @@ Ptr<MapNode> CoupledCluster::run() {
   OUT() << "Using mixer "
     << mixerType << ". " << mixer->describeOptions() << endl;
 
+  // write checkpoints every given number of iterations or minutes
+  // and resume from the most recent one
+  auto checkpointInterval(
+    arguments->getValue<Natural<>>("checkpointInterval", 0)
+  );
+  auto checkpointMinutes(arguments->getValue<Real<>>("checkpointMinutes", 0.0));
+  checkpointDirectory = arguments->getValue<std::string>(
+    "checkpointDirectory", "cc4s.checkpoint"
+  );
+  checkpointSlot = 0;
+  bool isCheckpointing(
+    (checkpointInterval > 0 || checkpointMinutes > 0) && !Cc4s::dryRun
+  );
+  if (isCheckpointing) {
+    checkpointKey = getCheckpointKey<F,TE>();
+    // explicitly given amplitudes take precedence over any checkpoint
+    if (amplitudes) {
+      OUT() << "Not resuming from checkpoints since initial amplitudes are given"
+        << std::endl;
+    } else {
+      i = readCheckpoint(amplitudes, mixer);
+    }
+  }
+  Time lastCheckpointTime(Time::getCurrentRealTime());
+
   // number of iterations for determining the amplitudes
   auto maxIterationsCount(
     arguments->getValue<size_t>("maxIterations", DEFAULT_MAX_ITERATIONS)
@@ -120,6 +157,7 @@ Ptr<MapNode> CoupledCluster::run() {
   OUT() << "Unless reaching energy convergence dE: " << energyConvergence << endl;
   OUT() << "and amplitudes convergence dR: " << amplitudesConvergence << endl;
   F e(0), previousE(0);
+  if (i > 0) previousE = getEnergy(amplitudes);
   Real<> residuumNorm;
   OUT()
     << "Iter         Energy         dE           dR         time   GF/s/rank"
@@ -133,7 +171,12 @@ Ptr<MapNode> CoupledCluster::run() {
     {
       Timer timer(&time);
       OperationsCounter operationsCounter(&operations);
-      auto residuum( method->getResiduum(amplitudes) );
+      TimerRegion iterationRegion("iteration");
+      Ptr<TensorSet<F,TE>> residuum;
+      {
+        TimerRegion residuumRegion("residuum");
+        residuum = method->getResiduum(amplitudes);
+      }
       residuumToAmplitudes(residuum, amplitudes);
       auto amplitudesChange( New<TensorSet<F,TE>>(*residuum) );
       if (amplitudes) {
@@ -142,10 +185,14 @@ Ptr<MapNode> CoupledCluster::run() {
       } else {
         isSecondOrder = true;
       }
-      mixer->append(residuum, amplitudesChange);
-      // get mixer's best guess for amplitudes
-      amplitudes = mixer->get();
-      residuumNorm = mixer->getResiduumNorm();
+      {
+        TimerRegion mixerRegion("mixer");
+        mixer->append(residuum, amplitudesChange);
+        // get mixer's best guess for amplitudes
+        amplitudes = mixer->get();
+        residuumNorm = mixer->getResiduumNorm();
+      }
+      TimerRegion energyRegion("energy");
       e = getEnergy(amplitudes);
     }
 
@@ -171,6 +218,24 @@ Ptr<MapNode> CoupledCluster::run() {
     ) {
       break;
     }
+    if (isCheckpointing) {
+      // all ranks follow the clock of rank 0
+      std::vector<Natural<>> isDue(
+        1, checkpointInterval > 0 && (i+1) % checkpointInterval == 0
+      );
+      if (
+        Cc4s::world->getRank() == 0 && checkpointMinutes > 0 &&
+        (Time::getCurrentRealTime() - lastCheckpointTime).getFractionalSeconds()
+          >= 60*checkpointMinutes
+      ) {
+        isDue[0] = 1;
+      }
+      Cc4s::world->broadcast(isDue);
+      if (isDue[0]) {
+        writeCheckpoint(i+1, amplitudes, mixer);
+        lastCheckpointTime = Time::getCurrentRealTime();
+      }
+    }
     previousE = e;
   }
 
@@ -183,6 +248,8 @@ Ptr<MapNode> CoupledCluster::run() {
 
   e = getEnergy(amplitudes, true);
   bool convergenceReached = i < maxIterationsCount;
+  // checkpoints are only needed to resume unfinished calculations
+  if (isCheckpointing && convergenceReached) removeCheckpoints();
 
   auto result(New<MapNode>(SOURCE_LOCATION));
   result->get("energy") = energy;
@@ -202,11 +269,16 @@ F CoupledCluster::getEnergy(
   auto coulombIntegrals(arguments->getPtr<TensorSet<F,TE>>("coulombIntegrals"));
 //  auto Vijab(coulombIntegrals->get("hhpp"));
   auto Vabij(coulombIntegrals->get("pphh"));
-  auto Vijab(Tcc<TE>::template tensor<F>("Vhhpp"));
-  COMPILE(
-    (*Vijab)["ijab"] <<= map<F>(conj<F>, (*Vabij)["abij"])
-  )->execute();
-  Vijab->inspect()->getUnit() = Vabij->inspect()->getUnit();
+  // conjugate only once, unless Vabij changes
+  auto Vijab(dynamicPtrCast<TensorExpression<F,TE>>(recipes["Vhhpp"]));
+  if (!Vijab) {
+    auto result(Tcc<TE>::template tensor<F>("Vhhpp"));
+    Vijab = PLAN(result,
+      (*result)["ijab"] <<= map<F>(conj<F>, (*Vabij)["abij"])
+    );
+    result->getUnit() = Vabij->inspect()->getUnit();
+    recipes["Vhhpp"] = Vijab;
+  }
 
   // TODO: get from size of spin properies
   Real<> degeneracy(2);
@@ -252,6 +324,237 @@ F CoupledCluster::getEnergy(
   return e;
 }
 
+template <typename F, typename TE>
+void CoupledCluster::writeCheckpoint(
+  const Natural<> iteration,
+  const Ptr<TensorSet<F,TE>> &amplitudes,
+  const Ptr<Mixer<F,TE>> &mixer
+) {
+  auto path(checkpointDirectory + "/Checkpoint" + std::to_string(checkpointSlot));
+  auto fileName(path + ".yaml");
+  OUT() << "Writing checkpoint after iteration " << iteration << " to "
+    << fileName << std::endl;
+  // the checkpoint is incomplete until its yaml file is written last
+  if (Cc4s::world->getRank() == 0) {
+    mkdir(checkpointDirectory.c_str(), 0755);
+    std::remove(fileName.c_str());
+  }
+  Cc4s::world->barrier();
+
+  auto checkpoint(New<MapNode>(SOURCE_LOCATION));
+  checkpoint->setValue<Natural<>>("iteration", iteration);
+  checkpoint->setValue<std::string>("key", checkpointKey);
+  if (energy->get("secondOrder")) {
+    checkpoint->setValue<Real<>>(
+      "secondOrder", energy->getValue<Real<>>("secondOrder")
+    );
+  }
+  checkpoint->setPtr("amplitudes", amplitudes);
+  auto mixerNode(New<MapNode>(SOURCE_LOCATION));
+  mixerNode->setValue<std::string>("type", mixer->getName());
+  auto mixerState(mixer->writeState(path + ".mixer"));
+  if (mixerState) mixerNode->get("state") = mixerState;
+  checkpoint->get("mixer") = mixerNode;
+  auto options(New<MapNode>(SOURCE_LOCATION));
+  options->setValue<std::string>("elementsType", "IeeeBinaryFile");
+  Writer(fileName, options).write(checkpoint);
+  checkpointSlot = 1 - checkpointSlot;
+}
+
+template <typename F, typename TE>
+Natural<> CoupledCluster::readCheckpoint(
+  Ptr<TensorSet<F,TE>> &amplitudes,
+  const Ptr<Mixer<F,TE>> &mixer
+) {
+  // only rank 0 checks for the files
+  std::vector<Natural<>> exists(2, 0);
+  if (Cc4s::world->getRank() == 0) {
+    for (Natural<> slot(0); slot < 2; ++slot) {
+      exists[slot] = std::ifstream(
+        checkpointDirectory + "/Checkpoint" + std::to_string(slot) + ".yaml"
+      ).good();
+    }
+  }
+  Cc4s::world->broadcast(exists);
+
+  // find the most recent checkpoint of the same calculation
+  Natural<> iteration(0), slot(0);
+  for (Natural<> candidateSlot(0); candidateSlot < 2; ++candidateSlot) {
+    if (!exists[candidateSlot]) continue;
+    auto fileName(
+      checkpointDirectory + "/Checkpoint" + std::to_string(candidateSlot) +
+        ".yaml"
+    );
+    auto candidate(Parser(fileName).parse()->toPtr<MapNode>());
+    if (
+      !candidate ||
+      candidate->getValue<std::string>("key", "") != checkpointKey ||
+      candidate->getMap("mixer")->getValue<std::string>("type") !=
+        mixer->getName()
+    ) {
+      WARNING() << "Ignoring checkpoint " << fileName
+        << " of a different calculation" << std::endl;
+      continue;
+    }
+    auto candidateIteration(candidate->getValue<Natural<>>("iteration"));
+    if (candidateIteration > iteration) {
+      iteration = candidateIteration;
+      slot = candidateSlot;
+    }
+  }
+  if (iteration == 0) return 0;
+
+  auto fileName(
+    checkpointDirectory + "/Checkpoint" + std::to_string(slot) + ".yaml"
+  );
+  OUT() << "Resuming from checkpoint " << fileName << " after iteration "
+    << iteration << std::endl;
+  auto checkpoint(Reader(fileName).read()->toPtr<MapNode>());
+  amplitudes = checkpoint->getPtr<TensorSet<F,TE>>("amplitudes");
+  auto mixerNode(checkpoint->getMap("mixer"));
+  if (mixerNode->isGiven("state")) {
+    mixer->readState(mixerNode->getMap("state"));
+  }
+  if (checkpoint->isGiven("secondOrder")) {
+    energy->setValue<Real<>>(
+      "secondOrder", checkpoint->getValue<Real<>>("secondOrder")
+    );
+  }
+  // keep the checkpoint read until the next one is complete
+  checkpointSlot = 1 - slot;
+  return iteration;
+}
+
+void CoupledCluster::removeCheckpoints() {
+  OUT() << "Removing checkpoints in " << checkpointDirectory << std::endl;
+  Cc4s::world->barrier();
+  if (Cc4s::world->getRank() == 0) {
+    auto directory(opendir(checkpointDirectory.c_str()));
+    if (directory) {
+      // checkpoints and the files they refer to start with Checkpoint
+      while (auto entry = readdir(directory)) {
+        std::string name(entry->d_name);
+        if (name.compare(0, 10, "Checkpoint") == 0) {
+          std::remove((checkpointDirectory + "/" + name).c_str());
+        }
+      }
+      closedir(directory);
+      rmdir(checkpointDirectory.c_str());
+    }
+  }
+  Cc4s::world->barrier();
+}
+
+template <typename F, typename TE>
+std::string CoupledCluster::getCheckpointKey() {
+  Natural<> h(0xcbf29ce484222325);
+  StepCache::hash(TypeTraits<F>::getName(), h);
+  // these arguments do not change the amplitudes a calculation converges to
+  std::set<std::string> ignoredKeys({
+    "checkpointInterval", "checkpointMinutes", "checkpointDirectory",
+    "maxIterations", "energyConvergence", "amplitudesConvergence",
+    "initialAmplitudes", "integralsSliceSize", "mixer"
+  });
+  for (auto key: arguments->getKeys()) {
+    if (ignoredKeys.count(key) > 0) continue;
+    StepCache::hash(key, h);
+    hashCheckpointArgument<TE>(arguments->get(key), h);
+  }
+  std::stringstream key;
+  key << std::hex << std::setw(16) << std::setfill('0') << h;
+  LOG() << "checkpoint key: " << key.str() << std::endl;
+  return key.str();
+}
+
+template <typename TE>
+void CoupledCluster::hashCheckpointArgument(
+  const Ptr<Node> &node, Natural<> &h
+) {
+  auto mapNode(node->toPtr<MapNode>());
+  if (mapNode) {
+    StepCache::hash("{", h);
+    for (auto key: mapNode->getKeys()) {
+      StepCache::hash(key, h);
+      hashCheckpointArgument<TE>(mapNode->get(key), h);
+    }
+    StepCache::hash("}", h);
+    return;
+  }
+  auto arrayNode(node->toPtr<ArrayNodeBase>());
+  if (arrayNode) {
+    StepCache::hash("[", h);
+    for (Natural<> i(0); i < arrayNode->getSize(); ++i) {
+      StepCache::hash(arrayNode->getElementString(i), h);
+    }
+    StepCache::hash("]", h);
+    return;
+  }
+  auto pointerNode(node->toPtr<AtomicNode<Ptr<Object>>>());
+  if (pointerNode) {
+    auto object(pointerNode->value);
+    bool isHashed(
+      hashCheckpointTensor<Real<>,TE>(object, h) ||
+      hashCheckpointTensor<Complex<>,TE>(object, h) ||
+      hashCheckpointTensorSet<Real<>,TE>(object, h) ||
+      hashCheckpointTensorSet<Complex<>,TE>(object, h)
+    );
+    ASSERT_LOCATION(
+      isHashed, "Unsupported object argument for checkpoints",
+      node->sourceLocation
+    );
+    return;
+  }
+  StepCache::hash(node->toString(), h);
+}
+
+template <typename G, typename TE>
+bool CoupledCluster::hashCheckpointTensor(
+  const Ptr<Object> &object, Natural<> &h
+) {
+  auto tensorExpression(dynamicPtrCast<TensorExpression<G,TE>>(object));
+  if (!tensorExpression) return false;
+  auto tensor(tensorExpression->inspect());
+  StepCache::hash(TypeTraits<G>::getName(), h);
+  auto lens(tensor->getLens());
+  StepCache::hash(lens.data(), lens.size() * sizeof(lens[0]), h);
+  auto identity(TensorIo::getReadIdentity(object));
+  if (identity.size() > 0) {
+    StepCache::hash(identity, h);
+    return true;
+  }
+  // recipes are not evaluated, they enter through their source arguments
+  if (dynamicPtrCast<TensorRecipe<G,TE>>(object)) return true;
+  // sum the hashes of all elements, independent of their distribution
+  std::vector<size_t> indices;
+  std::vector<G> values;
+  tensorExpression->evaluate()->readLocal(indices, values);
+  std::vector<Natural<>> localSum(1, 0), sum;
+  for (Natural<> i(0); i < indices.size(); ++i) {
+    Natural<> elementHash(0xcbf29ce484222325);
+    StepCache::hash(&indices[i], sizeof(size_t), elementHash);
+    StepCache::hash(&values[i], sizeof(G), elementHash);
+    localSum[0] += elementHash;
+  }
+  Cc4s::world->allReduce(localSum, sum);
+  StepCache::hash(sum.data(), sizeof(Natural<>), h);
+  return true;
+}
+
+template <typename G, typename TE>
+bool CoupledCluster::hashCheckpointTensorSet(
+  const Ptr<Object> &object, Natural<> &h
+) {
+  auto tensorSet(dynamicPtrCast<TensorSet<G,TE>>(object));
+  if (!tensorSet) return false;
+  StepCache::hash("{", h);
+  for (auto key: tensorSet->getKeys()) {
+    StepCache::hash(key, h);
+    hashCheckpointTensor<G,TE>(tensorSet->get(key), h);
+  }
+  StepCache::hash("}", h);
+  return true;
+}
+
 template <typename F, typename TE>
 void CoupledCluster::residuumToAmplitudes(
   const Ptr<TensorSet<F,TE>> &residuum,
@@ -269,23 +572,25 @@ void CoupledCluster::residuumToAmplitudes(
   for (auto key: residuum->getKeys()) {
     auto R( residuum->get(key) );
     auto indices( residuum->generateIndices(key) );
-    auto D( calculateEnergyDifferences<F,TE>(R->inspect()->getLens(),indices) );
+    auto D(
+      getInverseEnergyDifferences<F,TE>(R->inspect()->getLens(), indices)
+    );
 
     // divide by -Delta to get new estimate for T
     COMPILE(
-      (*D)[indices] <<= map<F>(
-        [levelShift](F delta) { return F(-1) / (delta + levelShift); },
-        (*D)[indices]
-      ),
       (*R)[indices] <<= (*R)[indices] * (*D)[indices]
     )->execute();
   }
 }
 
 template <typename F, typename TE>
-Ptr<Tensor<F,TE>> CoupledCluster::calculateEnergyDifferences(
+Ptr<TensorExpression<F,TE>> CoupledCluster::getInverseEnergyDifferences(
   const std::vector<size_t> &lens, const std::string &indices
 ) {
+  auto name(std::string("D") + indices);
+  auto cached(dynamicPtrCast<TensorExpression<F,TE>>(recipes[name]));
+  if (cached) return cached;
+
   auto eigenEnergies(
     arguments->getPtr<TensorSet<Real<>,TE>>("slicedEigenEnergies")
   );
@@ -293,26 +598,38 @@ Ptr<Tensor<F,TE>> CoupledCluster::calculateEnergyDifferences(
   auto epsp(eigenEnergies->get("p"));
   auto Fepsh(Tcc<TE>::template tensor<F>(epsh->inspect()->getLens(), "Fepsh"));
   auto Fepsp(Tcc<TE>::template tensor<F>(epsp->inspect()->getLens(), "Fepsp"));
+  auto D(Tcc<TE>::template tensor<F>(lens, name));
+  auto levelShift(
+    arguments->getValue<Real<>>("levelShift", DEFAULT_LEVEL_SHIFT)
+  );
+
   // convert to type F (either complex or double)
   auto fromReal( [](Real<> eps) {return F(eps);} );
-  COMPILE(
-    (*Fepsp)["a"] <<= map<F>(fromReal, (*epsp)["a"]),
-    (*Fepsh)["i"] <<= map<F>(fromReal, (*epsh)["i"])
-  )->execute();
-
-  auto D(
-    Tcc<TE>::template tensor<F>(lens, std::string("D") + indices)
+  auto sequence(
+    (
+      (*Fepsp)["a"] <<= map<F>(fromReal, (*epsp)["a"]),
+      (*Fepsh)["i"] <<= map<F>(fromReal, (*epsh)["i"])
+    )
   );
-
   // create energy difference tensor
   int excitationLevel(indices.length()/2);
   for (int p(0); p < excitationLevel; ++p) {
-    COMPILE(
+    sequence = (
+      sequence,
       (*D)[indices] += (*Fepsp)[indices.substr(p,1)],
       (*D)[indices] -= (*Fepsh)[indices.substr(excitationLevel+p,1)]
-    )->execute();
+    );
   }
-
+  // invert the level shifted energy differences in place
+  sequence = (
+    sequence,
+    (*D)[indices] <<= map<F>(
+      [levelShift](F delta) { return F(-1) / (delta + levelShift); },
+      (*D)[indices]
+    )
+  );
+  COMPILE(sequence)->execute();
+  recipes[name] = D;
   return D;
 }
 
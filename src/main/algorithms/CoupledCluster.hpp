@@ -18,8 +18,10 @@
 
 #include <algorithms/Algorithm.hpp>
 #include <TensorSet.hpp>
+#include <mixers/Mixer.hpp>
 #include <SharedPointer.hpp>
 
+#include <map>
 #include <string>
 #include <initializer_list>
 
@@ -80,12 +82,74 @@ namespace cc4s {
     );
 
     /**
-     * \brief Calculates eps_a+eps_b+...-eps_i-eps_j-... into D^ab..._ij...
+     * \brief Writes the amplitudes after the given iteration together with
+     * the state of the mixer into the next of two alternating checkpoints
+     * in the checkpointDirectory. A checkpoint is only complete once its
+     * yaml file exists.
      **/
     template <typename F, typename TE>
-    Ptr<Tensor<F,TE>> calculateEnergyDifferences(
+    void writeCheckpoint(
+      const Natural<> iteration,
+      const Ptr<TensorSet<F,TE>> &amplitudes,
+      const Ptr<Mixer<F,TE>> &mixer
+    );
+
+    /**
+     * \brief Reads the amplitudes and the state of the mixer from the most
+     * recent complete checkpoint with the same key and mixer type, if
+     * present, and returns the number of iterations done, or 0 otherwise.
+     **/
+    template <typename F, typename TE>
+    Natural<> readCheckpoint(
+      Ptr<TensorSet<F,TE>> &amplitudes,
+      const Ptr<Mixer<F,TE>> &mixer
+    );
+
+    /**
+     * \brief Removes all checkpoints from the checkpointDirectory
+     * and the directory itself, if it is then empty.
+     **/
+    void removeCheckpoints();
+
+    /**
+     * \brief Returns the key of the calculation a checkpoint belongs to.
+     * It is a hash of the scalar type and of all arguments except those
+     * controlling only checkpoints, convergence and the mixer.
+     * Tensors enter with their shape and with the identity of the file they
+     * were read from or, if they are not recipes, with their elements.
+     **/
+    template <typename F, typename TE>
+    std::string getCheckpointKey();
+    template <typename TE>
+    void hashCheckpointArgument(const Ptr<Node> &node, Natural<> &h);
+    template <typename G, typename TE>
+    bool hashCheckpointTensor(const Ptr<Object> &object, Natural<> &h);
+    template <typename G, typename TE>
+    bool hashCheckpointTensorSet(const Ptr<Object> &object, Natural<> &h);
+
+    std::string checkpointDirectory, checkpointKey;
+    /**
+     * \brief Index of the alternating checkpoint to write next.
+     **/
+    Natural<> checkpointSlot;
+
+    /**
+     * \brief Returns the inverse energy differences
+     * \f$-1/(\Delta_{ij\ldots}^{ab\ldots}+s)\f$ with the level shift s,
+     * where \f$\Delta_{ij\ldots}^{ab\ldots} =
+       \varepsilon_a+\ldots-\varepsilon_i-\ldots\f$.
+     * They are calculated upon first use during a run.
+     **/
+    template <typename F, typename TE>
+    Ptr<TensorExpression<F,TE>> getInverseEnergyDifferences(
       const std::vector<size_t> &lens, const std::string &indices
     );
+
+    /**
+     * \brief Iteration invariant tensors and recipes by name, created
+     * upon first use during a run.
+     **/
+    std::map<std::string, Ptr<Object>> recipes;
   };
 }
 
@@ -41,13 +41,13 @@ Ptr<MapNode> DefineHolesAndParticles::run(
 ) {
   auto eps(arguments->getPtr<TensorExpression<Real<>,TE>>("eigenEnergies"));
   Ptr<MapNode> metaData(eps->inspect()->getMetaData());
-  auto energies(metaData->getMap("energies"));
+  auto energies(metaData->getArray<Real<>>("energies"));
   auto Np(energies->getSize());
 
   // find fermi energy to determine No and Nv
   auto fermiEnergy(metaData->getValue<Real<>>("fermiEnergy"));
   size_t No(0);
-  while (No < Np && energies->getValue<Real<>>(No) < fermiEnergy) { ++No; }
+  while (No < Np && (*energies)[No] < fermiEnergy) { ++No; }
   ASSERT_LOCATION(
     0 < No, "Fermi energy below all eigen energies.",
     metaData->sourceLocation
@@ -0,0 +1,281 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithms/FrozenNaturalOrbitals.hpp>
+#include <tcc/Tcc.hpp>
+#include <MathFunctions.hpp>
+#include <lapack/LapackHermitianEigenSystem.hpp>
+#include <Log.hpp>
+#include <Exception.hpp>
+#include <Cc4s.hpp>
+
+using namespace cc4s;
+
+
+ALGORITHM_REGISTRAR_DEFINITION(FrozenNaturalOrbitals)
+
+Ptr<MapNode> FrozenNaturalOrbitals::run(const Ptr<MapNode> &arguments) {
+  // multiplex calls to template methods
+  Ptr<MapNode> result;
+  if (Cc4s::dryRun) {
+    using TE = DefaultDryTensorEngine;
+    (
+      result = run<Real<>,TE>(arguments)
+    ) || (
+      result = run<Complex<>,TE>(arguments)
+    );
+  } else {
+    using TE = DefaultTensorEngine;
+    (
+      result = run<Real<>,TE>(arguments)
+    ) || (
+      result = run<Complex<>,TE>(arguments)
+    );
+  }
+  ASSERT_LOCATION(
+    result, "unsupported tensor type as 'coulombIntegrals'",
+    arguments->sourceLocation
+  );
+  return result;
+}
+
+template <typename F, typename TE>
+Ptr<MapNode> FrozenNaturalOrbitals::run(
+  const Ptr<MapNode> &arguments
+) {
+  auto coulombIntegrals(arguments->getPtr<TensorSet<F,TE>>("coulombIntegrals"));
+  if (!coulombIntegrals) return nullptr;
+  auto Vpphh(coulombIntegrals->get("pphh"));
+  auto slicedCoulombVertex(
+    arguments->getPtr<TensorSet<Complex<>,TE>>("slicedCoulombVertex")
+  );
+  ASSERT_LOCATION(
+    slicedCoulombVertex,
+    "expecting TensorSet of Complex64 as 'slicedCoulombVertex'",
+    arguments->sourceLocation
+  );
+  auto occupationThreshold(
+    arguments->getValue<Real<>>("occupationThreshold", 1e-5)
+  );
+  auto particlesCount(arguments->getValue<Natural<>>("particlesCount", 0));
+
+  auto stateDimension(
+    TensorDimension::dimensions["State"]
+  );
+  ASSERT(
+    stateDimension, "Dimension information for 'State' expected"
+  );
+  Real<> degeneracy(2.0);
+  auto spinProperty(
+    stateDimension->properties["Spin"]
+  );
+  if (spinProperty) {
+    // FIXME: workaround for identifying closed-shell states
+    auto statesCountHavingFirstSpin(
+      spinProperty->indicesOfProperty[0].size()
+    );
+    auto statesCountTotal(
+      spinProperty->propertyOfIndex.size()
+    );
+    if (statesCountHavingFirstSpin < statesCountTotal) {
+      // definitely open-shell
+      degeneracy = 1.0;
+    }
+  }
+
+  auto eigenEnergies(
+    arguments->getPtr<TensorSet<Real<>,TE>>("slicedEigenEnergies")
+  );
+  auto epsh(eigenEnergies->get("h"));
+  auto epsp(eigenEnergies->get("p"));
+  auto No(epsh->inspect()->getLen(0));
+  auto Nv(epsp->inspect()->getLen(0));
+
+  // first-order doubles amplitudes as in SecondOrderPerturbationTheory
+  auto Dph(
+    Tcc<TE>::template tensor<F>(std::vector<Natural<>>({Nv,No}),"Dph")
+  );
+  auto Tpphh(
+    Tcc<TE>::template tensor<F>(std::vector<Natural<>>({Nv,Nv,No,No}),"Tpphh")
+  );
+  auto Dpp( Tcc<TE>::template tensor<F>("Dpp") );
+  OUT() << "Contracting second order particle density..." << std::endl;
+  COMPILE(
+    (*Dph)["ai"] <<= map<F>([](Real<> eps) {return F(eps);}, (*epsp)["a"]),
+    (*Dph)["ai"] -=  map<F>([](Real<> eps) {return F(eps);}, (*epsh)["i"]),
+    (*Tpphh)["abij"] <<= (*Dph)["ai"],
+    (*Tpphh)["abij"] +=  (*Dph)["bj"],
+    (*Tpphh)["abij"] <<=
+      map<F>(conj<F>, (*Vpphh)["abij"]) *
+      map<F>([](F delta) { return F(1/real(delta)); }, (*Tpphh)["abij"]),
+    // particle-particle block of the density matrix, for closed shells
+    // summed over both spins
+    (*Dpp)["ab"] <<=
+      degeneracy * (*Tpphh)["acij"] * map<F>(conj<F>, (*Tpphh)["bcij"]),
+    (*Dpp)["ab"] -=
+      (*Tpphh)["acij"] * map<F>(conj<F>, (*Tpphh)["cbij"])
+  )->execute();
+
+  // without elements in a dry run, assume the given or all particles
+  Natural<> NvKept(particlesCount > 0 ? std::min(particlesCount, Nv) : Nv);
+  // rotation from the particles to the retained, semicanonical orbitals
+  std::vector<Complex<>> rotation;
+  std::vector<Real<>> energies;
+  if (!Cc4s::dryRun) {
+    auto density(Dpp->readAll());
+    // diagonalize on root only, all ranks need identical eigenvectors
+    std::vector<Real<>> occupations(Nv);
+    if (Cc4s::world->getRank() == 0) {
+      occupations = diagonalize(density, Nv);
+    }
+    Cc4s::world->broadcast(density);
+    Cc4s::world->broadcast(occupations);
+    // occupations are in ascending order
+    if (particlesCount == 0) {
+      NvKept = 0;
+      while (NvKept < Nv && occupations[Nv-1-NvKept] >= occupationThreshold) {
+        ++NvKept;
+      }
+      NvKept = std::max(NvKept, Natural<>(1));
+    }
+    std::vector<Natural<>> NvKeptBroadcast(1, NvKept);
+    Cc4s::world->broadcast(NvKeptBroadcast);
+    NvKept = NvKeptBroadcast[0];
+    OUT() << "largest occupation: " << occupations[Nv-1] << std::endl;
+    OUT() << "smallest retained occupation: " << occupations[Nv-NvKept]
+      << std::endl;
+    // the vertex transforms contragrediently to the amplitudes
+    std::vector<F> naturalOrbitals(Nv*NvKept);
+    for (Natural<> x(0); x < NvKept; ++x) {
+      for (Natural<> a(0); a < Nv; ++a) {
+        naturalOrbitals[a+Nv*x] = conj<F>(density[a+Nv*(Nv-1-x)]);
+      }
+    }
+    // semicanonicalize: diagonalize the Fock matrix of the retained orbitals
+    auto eps(epsp->evaluate()->readAll());
+    std::vector<F> fock(NvKept*NvKept);
+    for (Natural<> y(0); y < NvKept; ++y) {
+      for (Natural<> x(0); x < NvKept; ++x) {
+        F f(0);
+        for (Natural<> a(0); a < Nv; ++a) {
+          f += conj<F>(naturalOrbitals[a+Nv*x]) * eps[a] *
+            naturalOrbitals[a+Nv*y];
+        }
+        fock[x+NvKept*y] = f;
+      }
+    }
+    energies.resize(NvKept);
+    if (Cc4s::world->getRank() == 0) {
+      energies = diagonalize(fock, NvKept);
+    }
+    Cc4s::world->broadcast(fock);
+    Cc4s::world->broadcast(energies);
+    rotation.resize(Nv*NvKept);
+    for (Natural<> z(0); z < NvKept; ++z) {
+      for (Natural<> a(0); a < Nv; ++a) {
+        F c(0);
+        for (Natural<> x(0); x < NvKept; ++x) {
+          c += naturalOrbitals[a+Nv*x] * fock[x+NvKept*z];
+        }
+        rotation[a+Nv*z] = Complex<>(c);
+      }
+    }
+  }
+  OUT() << "number of particles Nv: " << Nv << " -> " << NvKept << std::endl;
+
+  auto C(
+    Tcc<TE>::template tensor<Complex<>>(
+      std::vector<Natural<>>({Nv,NvKept}), "C"
+    )
+  );
+  auto epspKept(
+    Tcc<TE>::template tensor<Real<>>(std::vector<Natural<>>({NvKept}), "epsp")
+  );
+  // write all elements on root
+  if (Cc4s::world->getRank() != 0) {
+    rotation.clear();
+    energies.clear();
+  }
+  std::vector<Natural<>> indices(std::max(rotation.size(), energies.size()));
+  for (Natural<> i(0); i < indices.size(); ++i) indices[i] = i;
+  C->write(rotation.size(), indices.data(), rotation.data());
+  epspKept->write(energies.size(), indices.data(), energies.data());
+  // TODO: units and meta data should be entered in tcc
+  epspKept->getUnit() = epsp->inspect()->getUnit();
+  epspKept->dimensions = epsp->inspect()->dimensions;
+
+  auto GammaGhh(slicedCoulombVertex->get("hh"));
+  auto GammaGhp(slicedCoulombVertex->get("hp"));
+  auto GammaGph(slicedCoulombVertex->get("ph"));
+  auto GammaGpp(slicedCoulombVertex->get("pp"));
+  auto rotatedGammaGhp( Tcc<TE>::template tensor<Complex<>>("GammaGhp") );
+  auto rotatedGammaGph( Tcc<TE>::template tensor<Complex<>>("GammaGph") );
+  auto rotatedGammaGpp( Tcc<TE>::template tensor<Complex<>>("GammaGpp") );
+  auto conjC( Tcc<TE>::template tensor<Complex<>>("conjC") );
+  OUT() << "Rotating particle slices of the Coulomb vertex..." << std::endl;
+  COMPILE(
+    (*conjC)["ax"] <<= map<Complex<>>(conj<Complex<>>, (*C)["ax"]),
+    (*rotatedGammaGhp)["Giy"] <<= (*GammaGhp)["Gib"] * (*C)["by"],
+    (*rotatedGammaGph)["Gxi"] <<= (*conjC)["ax"] * (*GammaGph)["Gai"],
+    (*rotatedGammaGpp)["Gxy"] <<=
+      (*conjC)["ax"] * (*GammaGpp)["Gab"] * (*C)["by"]
+  )->execute();
+  // TODO: transfer dimension info, unit and meta-data in tcc
+  for (
+    auto pair: std::vector<
+      std::pair<Ptr<Tensor<Complex<>,TE>>, Ptr<TensorExpression<Complex<>,TE>>>
+    >({
+      {rotatedGammaGhp, GammaGhp},
+      {rotatedGammaGph, GammaGph},
+      {rotatedGammaGpp, GammaGpp}
+    })
+  ) {
+    pair.first->dimensions = pair.second->inspect()->dimensions;
+    pair.first->getUnit() = pair.second->inspect()->getUnit();
+    pair.first->getMetaData() = pair.second->inspect()->getMetaData();
+  }
+
+  // create result
+  auto rotatedCoulombVertex(
+    New<TensorSet<Complex<>,TE>>(
+      std::map<std::string,Ptr<TensorExpression<Complex<>,TE>>>({
+        {"hh", GammaGhh}, {"hp", rotatedGammaGhp},
+        {"ph", rotatedGammaGph}, {"pp", rotatedGammaGpp}
+      })
+    )
+  );
+  auto slicedEigenEnergies(
+    New<TensorSet<Real<>,TE>>(
+      std::map<std::string,Ptr<TensorExpression<Real<>,TE>>>(
+        {{"h",epsh}, {"p",epspKept}}
+      )
+    )
+  );
+  auto result(New<MapNode>(SOURCE_LOCATION));
+  result->setPtr("slicedCoulombVertex", rotatedCoulombVertex);
+  result->setPtr("slicedEigenEnergies", slicedEigenEnergies);
+  result->setValue("particlesCount", NvKept);
+  return result;
+}
+
+template <typename F>
+std::vector<Real<>> FrozenNaturalOrbitals::diagonalize(
+  std::vector<F> &matrix, const int n
+) {
+  LapackHermitianEigenSystem<F> eigenSystem(LapackMatrix<F>(n, n, matrix));
+  auto eigenVectors(eigenSystem.getEigenVectors().getValues());
+  matrix.assign(eigenVectors, eigenVectors + n*n);
+  return eigenSystem.getEigenValues();
+}
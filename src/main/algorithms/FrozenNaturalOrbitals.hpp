@@ -0,0 +1,58 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FROZEN_NATURAL_ORBITALS_DEFINED
+#define FROZEN_NATURAL_ORBITALS_DEFINED
+
+#include <algorithms/Algorithm.hpp>
+
+#include <TensorSet.hpp>
+
+#include <vector>
+
+namespace cc4s {
+  /**
+   * \brief Compresses the virtual space to the frozen natural orbitals,
+   * i.e. the eigenvectors of the virtual-virtual block of the second
+   * order density matrix with occupation numbers above the given
+   * occupationThreshold, or the given number of particles.
+   * The retained orbitals are semicanonicalized and the particle slices
+   * of the sliced Coulomb vertex are rotated accordingly, such that
+   * later steps can use the returned slicedCoulombVertex and
+   * slicedEigenEnergies unchanged.
+   */
+  class FrozenNaturalOrbitals: public Algorithm {
+  public:
+    ALGORITHM_REGISTRAR_DECLARATION(FrozenNaturalOrbitals)
+
+    Ptr<MapNode> run(const Ptr<MapNode> &arguments) override;
+  protected:
+    template <typename F, typename TE>
+    Ptr<MapNode> run(const Ptr<MapNode> &arguments);
+
+    /**
+     * \brief Diagonalizes the given hermitian n x n matrix in column
+     * major order, overwriting it by its eigenvectors. The eigenvalues
+     * are returned in ascending order.
+     **/
+    template <typename F>
+    static std::vector<Real<>> diagonalize(
+      std::vector<F> &matrix, const int n
+    );
+  };
+}
+
+#endif
+
@@ -28,6 +28,71 @@
 using namespace cc4s;
 ALGORITHM_REGISTRAR_DEFINITION(PerturbativeTriples)
 
+/**
+ * \brief Estimates the memory in bytes needed by atrip on all ranks
+ * together, given the number of occupied and virtual orbitals.
+ **/
+template <typename F>
+Natural<128> getAtripMemory(const Natural<128> no, const Natural<128> nv) {
+  const
+  Natural<128>
+      nranks = Cc4s::getProcessesCount()
+    , f = sizeof(F)
+    , n_tuples = nv * (nv + 1) * (nv + 2) / 6 - nv
+    , atrip_memory
+        = /* tuples_memory */ 3 * sizeof(size_t) * n_tuples
+          //
+          // one dimensional slices (all ranks)
+          //
+        + /* taphh */ f * nranks * 6 * nv * no * no
+        + /* hhha  */ f * nranks * 6 * no * no * no
+          //
+          // two dimensional slices (all ranks)
+          //
+        + /* abph  */ f * nranks * 12 * nv * no
+        + /* abhh  */ f * nranks *  6 * no * no
+        + /* tabhh */ f * nranks *  6 * no * no
+          //
+          // distributed sources (all ranks)
+          //
+        + /* tpphh */ f * nv * nv * no * no
+        + /* vhhhp */ f * no * no * no * nv
+        + /* vppph */ f * nv * nv * nv * no
+        + /* vpphh */ f * nv * nv * no * no
+        + /* tpphh2 */ f * nv * nv * no * no
+          //
+          // tensors in every rank
+          //
+        + /* tijk */ f * nranks * no * no * no
+        + /* zijk */ f * nranks * no * no * no
+        + /* epsp */ f * nranks * (no + nv)
+        + /* tai  */ f * nranks * no * nv
+    ;
+  return atrip_memory;
+}
+
+/**
+ * \brief Warns if the memory estimated for atrip exceeds the memory
+ * available to all ranks.
+ **/
+template <typename F>
+void checkAtripMemory(
+  const Natural<128> no, const Natural<128> nv,
+  const SourceLocation &sourceLocation
+) {
+  auto atripMemory(getAtripMemory<F>(no, nv));
+  auto memory(
+    Natural<128>(Cc4s::getMemoryPerRank()) * Cc4s::getProcessesCount()
+  );
+  if (atripMemory > memory) {
+    auto GB(1024.0*1024.0*1024.0);
+    WARNING_LOCATION(sourceLocation) << "atrip needs an estimated "
+      << atripMemory / GB / Cc4s::getProcessesCount() << " GB per rank, "
+      << "exceeding the " << memory / GB / Cc4s::getProcessesCount()
+      << " GB available. Use more ranks." << std::endl;
+  }
+}
+
 template <typename F, typename TE>
 Ptr<MapNode> runAtrip(const Ptr<MapNode> &arguments) {
   {
@@ -188,7 +253,9 @@ Ptr<MapNode> runAtrip(const Ptr<MapNode> &arguments) {
                             * 6.0
                             / 1.0e9
                             ;
-
+  checkAtripMemory<F>(
+    *(__eps__(h))->lens, *(__eps__(p))->lens, arguments->sourceLocation
+  );
 
   double lastElapsedTime = 0;
   auto const rank = Cc4s::world->getRank();
@@ -272,38 +339,9 @@ Ptr<MapNode> atripDryRun(const Ptr<MapNode> &arguments) {
   Natural<128>
       no = epsh->inspect()->getLen(0)
     , nv = epsp->inspect()->getLen(0)
-    , nranks = Cc4s::getProcessesCount()
-    , f = sizeof(F)
-    , n_tuples = nv * (nv + 1) * (nv + 2) / 6 - nv
-    , atrip_memory
-        = /* tuples_memory */ 3 * sizeof(size_t) * n_tuples
-          //
-          // one dimensional slices (all ranks)
-          //
-        + /* taphh */ f * nranks * 6 * nv * no * no
-        + /* hhha  */ f * nranks * 6 * no * no * no
-          //
-          // two dimensional slices (all ranks)
-          //
-        + /* abph  */ f * nranks * 12 * nv * no
-        + /* abhh  */ f * nranks *  6 * no * no
-        + /* tabhh */ f * nranks *  6 * no * no
-          //
-          // distributed sources (all ranks)
-          //
-        + /* tpphh */ f * nv * nv * no * no
-        + /* vhhhp */ f * no * no * no * nv
-        + /* vppph */ f * nv * nv * nv * no
-        + /* vpphh */ f * nv * nv * no * no
-        + /* tpphh2 */ f * nv * nv * no * no
-          //
-          // tensors in every rank
-          //
-        + /* tijk */ f * nranks * no * no * no
-        + /* zijk */ f * nranks * no * no * no
-        + /* epsp */ f * nranks * (no + nv)
-        + /* tai  */ f * nranks * no * nv
+    , atrip_memory = getAtripMemory<F>(no, nv)
     ;
+  checkAtripMemory<F>(no, nv, arguments->sourceLocation);
   DryMemory::allocate(atrip_memory, SOURCE_LOCATION);
   DryMemory::free(atrip_memory);
   Operation<TE>::addFloatingPointOperations(no*no*no*nv*nv*nv*(no+nv)*2);
@@ -16,6 +16,7 @@
 #include <algorithms/PerturbativeTriplesStar.hpp>
 #include <algorithms/PerturbativeTriplesReference.hpp>
 #include <algorithms/CompleteTriples.hpp>
+#include <algorithms/VertexCoulombIntegrals.hpp>
 #include <tcc/Tcc.hpp>
 #include <TensorSet.hpp>
 #include <MathFunctions.hpp>
@@ -62,8 +63,17 @@ Ptr<MapNode> PerturbativeTriplesReference::run(const Ptr<MapNode> &arguments) {
 
   auto coulombIntegrals(arguments->getPtr<TensorSet<F,TE>>("coulombIntegrals"));
   auto Vpphh(coulombIntegrals->get("pphh"));
-  auto Vppph(coulombIntegrals->get("ppph"));
   auto Vhhhp(coulombIntegrals->get("hhhp"));
+  // contract Vppph through the vertex, if its factors are given
+  auto coulombVertexFactors(
+    arguments->isGiven("coulombVertexFactors") ?
+      arguments->getPtr<TensorSet<F,TE>>("coulombVertexFactors") : nullptr
+  );
+  auto Vppph(
+    VertexCoulombIntegrals::getIntegrals<F,TE>(
+      coulombIntegrals, coulombVertexFactors, "ppph", "bcdk"
+    )
+  );
 
   const bool cT
      = arguments->getValue<int>("cT", 0) == 1;
@@ -90,7 +100,9 @@ Ptr<MapNode> PerturbativeTriplesReference::run(const Ptr<MapNode> &arguments) {
 
   // deal with cT
   if (cT) {
-    intermediates = ct::getCompleteTriples<F, TE>(coulombIntegrals, amplitudes);
+    intermediates = ct::getCompleteTriples<F, TE>(
+      coulombIntegrals, amplitudes, coulombVertexFactors
+    );
     auto Jppph = intermediates->get("ppph");
     auto Jhphh = intermediates->get("hphh");
     COMPILE(
@@ -111,7 +123,7 @@ Ptr<MapNode> PerturbativeTriplesReference::run(const Ptr<MapNode> &arguments) {
 
   COMPILE(
 
-    (*T)["abcijk"]  <<=          (*Vppph)["bcdk"] * (*Tpphh)["adij"],
+    (*T)["abcijk"]  <<=          Vppph * (*Tpphh)["adij"],
     (*T)["abcijk"]   += (-1.0) * map<F>(conj<F>, (*Vhhhp)["jklc"]) * (*Tpphh)["abil"],
     (*Z)["abcijk"]  <<= (*T)["abcijk"],
     (*Z)["abcijk"]   += (*T)["bacjik"],
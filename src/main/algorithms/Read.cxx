@@ -23,13 +23,24 @@ using namespace cc4s;
 ALGORITHM_REGISTRAR_DEFINITION(Read)
 
 /**
- * \brief Interface to Reader.
+ * \brief Interface to Reader. Optionally, only the hyper-rectangle
+ * given by the lists begins and ends is read from the tensors, where
+ * begins default to 0 and ends to the lengths of the tensors.
+ * If lazy is true, tensor elements are only read upon first use.
  */
 Ptr<MapNode> Read::run(const Ptr<MapNode> &arguments) {
   auto fileName(arguments->getValue<std::string>("fileName"));
+  auto options(New<MapNode>(arguments->sourceLocation));
+  options->setValue("lazy", arguments->getValue<bool>("lazy", false));
+  // a missing begins or ends defaults to the start or end of each dimension
+  for (auto key: {"begins", "ends"}) {
+    if (arguments->isGiven(key)) {
+      options->get(key) = arguments->getArray<Natural<>>(key);
+    }
+  }
 
   try {
-    auto destination(Reader(fileName).read());
+    auto destination(Reader(fileName, options).read());
     // create result
     auto result(New<MapNode>(destination->sourceLocation));
     result->get("destination") = destination;
@@ -24,6 +24,9 @@ namespace cc4s {
   public:
     ALGORITHM_REGISTRAR_DECLARATION(Read)
     Ptr<MapNode> run(const Ptr<MapNode> &arguments) override;
+    bool isDeterministic() override {
+      return false;
+    }
   };
 }
 
@@ -98,35 +98,84 @@ Ptr<MapNode> SecondOrderPerturbationTheory::run(
   auto Dph(
     Tcc<TE>::template tensor<F>(std::vector<Natural<>>({Nv,No}),"Dph")
   );
-  auto Dpphh(
-    Tcc<TE>::template tensor<F>(std::vector<Natural<>>({Nv,Nv,No,No}),"Dpphh")
-  );
   auto singles( Tcc<TE>::template tensor<F>("S") );
   auto direct( Tcc<TE>::template tensor<F>("D") );
   auto exchange( Tcc<TE>::template tensor<F>("X") );
-  OUT() << "Contracting second order energy..." << std::endl;
   COMPILE(
     (*Dph)["ai"] <<= map<F>([](Real<> eps) {return F(eps);}, (*epsp)["a"]),
-    (*Dph)["ai"] -=  map<F>([](Real<> eps) {return F(eps);}, (*epsh)["i"]),
-    (*Dpphh)["abij"] <<= (*Dph)["ai"],
-    (*Dpphh)["abij"] +=  (*Dph)["bj"],
+    (*Dph)["ai"] -=  map<F>([](Real<> eps) {return F(eps);}, (*epsh)["i"])
+  )->execute();
+
+  F D(0), X(0);
+  auto coulombVertexFactors(
+    arguments->isGiven("coulombVertexFactors") ?
+      arguments->getPtr<TensorSet<F,TE>>("coulombVertexFactors") : nullptr
+  );
+  if (coulombVertexFactors) {
+    // form the integrals of a batch of holes i from the vertex factors,
+    // never building the entire Vpphh or Dpphh. The factors are recipes
+    // evaluated upon first use only.
+    auto Lph(coulombVertexFactors->get("Lph"));
+    auto Rph(coulombVertexFactors->get("Rph"));
+    auto NG(Lph->inspect()->getLen(0));
+    auto batchSize(getHolesBatchSize<F>(arguments, No, Nv));
+    OUT() << "Contracting second order energy in batches of "
+      << batchSize << " holes..." << std::endl;
+    for (Natural<> i0(0); i0 < No; i0 += batchSize) {
+      Natural<> i1(std::min(i0+batchSize, No));
+      auto Vabij( Tcc<TE>::template tensor<F>("Vabij") );
+      auto Vabji( Tcc<TE>::template tensor<F>("Vabji") );
+      auto Tabij( Tcc<TE>::template tensor<F>("Tabij") );
+      COMPILE(
+        (*Vabij)["abij"] <<=
+          (*(*Lph)({0, 0, i0}, {NG, Nv, i1}))["Gai"] * (*Rph)["Gbj"],
+        (*Vabji)["abji"] <<=
+          (*Lph)["Gaj"] * (*(*Rph)({0, 0, i0}, {NG, Nv, i1}))["Gbi"],
+        (*Tabij)["abij"] <<= (*(*Dph)({0, i0}, {Nv, i1}))["ai"],
+        (*Tabij)["abij"] +=  (*Dph)["bj"],
+        (*Tabij)["abij"] <<=
+          map<F>(conj<F>, (*Vabij)["abij"]) *
+          map<F>([](F delta) { return F(1/real(delta)); }, (*Tabij)["abij"]),
+        (*direct)[""] <<=
+          -0.5*degeneracy*degeneracy * (*Vabij)["abij"] * (*Tabij)["abij"],
+        (*exchange)[""] <<=
+          +0.5*degeneracy * (*Vabji)["abji"] * (*Tabij)["abij"]
+      )->execute();
+      D += direct->read();
+      X += exchange->read();
+    }
+  } else {
+    auto Dpphh(
+      Tcc<TE>::template tensor<F>(
+        std::vector<Natural<>>({Nv,Nv,No,No}),"Dpphh"
+      )
+    );
+    OUT() << "Contracting second order energy..." << std::endl;
+    COMPILE(
+      (*Dpphh)["abij"] <<= (*Dph)["ai"],
+      (*Dpphh)["abij"] +=  (*Dph)["bj"],
+      // first-order doubles amplitudes
+      (*Dpphh)["abij"] <<=
+        map<F>(conj<F>, (*Vpphh)["abij"]) *
+        map<F>([](F delta) { return F(1/real(delta)); }, (*Dpphh)["abij"]),
+      (*direct)[""] <<=
+        -0.5*degeneracy*degeneracy * (*Vpphh)["abij"] * (*Dpphh)["abij"],
+      (*exchange)[""] <<=
+        +0.5*degeneracy * (*Vpphh)["abji"] * (*Dpphh)["abij"]
+    )->execute();
+    D = direct->read();
+    X = exchange->read();
+  }
+  COMPILE(
     // first-order singles amplitudes
     (*Dph)["ai"] <<=
       map<F>(conj<F>, (*fph)["ai"]) *
       map<F>([](F delta) { return F(1/real(delta)); }, (*Dph)["ai"]),
-    // first-order doubles amplitudes
-    (*Dpphh)["abij"] <<=
-      map<F>(conj<F>, (*Vpphh)["abij"]) *
-      map<F>([](F delta) { return F(1/real(delta)); }, (*Dpphh)["abij"]),
     (*singles)[""] <<=
-      -degeneracy * (*fph)["ai"] * (*Dph)["ai"],
-    (*direct)[""] <<=
-      -0.5*degeneracy*degeneracy * (*Vpphh)["abij"] * (*Dpphh)["abij"],
-    (*exchange)[""] <<=
-      +0.5*degeneracy * (*Vpphh)["abji"] * (*Dpphh)["abij"]
+      -degeneracy * (*fph)["ai"] * (*Dph)["ai"]
   )->execute();
 
-  F S(singles->read()), D(direct->read()), X(exchange->read());
+  F S(singles->read());
   OUT() << "correlation energy: " << S+D+X << std::endl;
   OUT() << "  singles:  " << S << std::endl;
   OUT() << "  direct:   " << D << std::endl;
@@ -148,6 +197,21 @@ Ptr<MapNode> SecondOrderPerturbationTheory::run(
   return result;
 }
 
+template <typename F>
+Natural<> SecondOrderPerturbationTheory::getHolesBatchSize(
+  const Ptr<MapNode> &arguments, const Natural<> No, const Natural<> Nv
+) {
+  auto givenBatchSize(arguments->getValue<Natural<>>("holesBatchSize", 0));
+  if (givenBatchSize > 0) return std::min(givenBatchSize, No);
+  // Vabij, Vabji and Tabij for a batch of holes i
+  Natural<128> memory(
+    Natural<128>(Cc4s::getMemoryShare(Cc4s::SLICES_MEMORY)) *
+      Cc4s::getProcessesCount()
+  );
+  auto batchSize(Natural<>(memory / (3 * sizeof(F) * Nv*Nv*No)));
+  return std::max(Natural<>(1), std::min(batchSize, No));
+}
+
 template <typename F, typename TE>
 Ptr<TensorSet<F,TE>> SecondOrderPerturbationTheory::getFockOperator(
   const Ptr<MapNode> &arguments
@@ -23,6 +23,8 @@
 namespace cc4s {
   /**
    * \brief Caclulates the second order energy from the pphh Coulomb integrals.
+   * If coulombVertexFactors are given, the integrals are formed from the
+   * vertex in batches of holesBatchSize holes instead.
    */
   class SecondOrderPerturbationTheory: public Algorithm {
   public:
@@ -35,6 +37,17 @@ namespace cc4s {
 
     template <typename F, typename TE>
     Ptr<TensorSet<F,TE>> getFockOperator(const Ptr<MapNode> &arguments);
+
+    /**
+     * \brief Returns the holesBatchSize argument or, if not given,
+     * the largest number of holes per batch such that the integrals
+     * and amplitudes of a batch fit into the slices share of the memory
+     * of all ranks.
+     **/
+    template <typename F>
+    Natural<> getHolesBatchSize(
+      const Ptr<MapNode> &arguments, const Natural<> No, const Natural<> Nv
+    );
   };
 }
 
@@ -116,13 +116,19 @@ void TensorReader::readData(
         nonZeroCondition->dimensionPropertyReferences.push_back(dimensionProperty);
         ++D;
       }
-      auto tuplesMap(allMap->getMap(key)->getMap("nonZeros"));
-      for (Natural<> i(0); i < tuplesMap->getSize(); ++i) {
-        std::vector<Natural<>> tuple(D);
-        for (Natural<> d(0); d < D; ++d) {
-          tuple[d] = tuplesMap->getMap(i)->getValue<Natural<>>(d);
-        }
-        nonZeroCondition->tuples.push_back(tuple);
+      // tuples are read as one dense array
+      auto tuples(
+        allMap->getMap(key)->getTupleArray<Natural<>>("nonZeros")
+      );
+      auto tuplesCount(tuples->getSize());
+      ASSERT_LOCATION(
+        tuplesCount == 0 || tuples->tupleSize == D,
+        "Expecting " + std::to_string(D) + " indices per non-zero tuple",
+        tuples->sourceLocation
+      );
+      nonZeroCondition->tuples.reserve(tuplesCount);
+      for (Natural<> i(0); i < tuplesCount; ++i) {
+        nonZeroCondition->tuples.push_back(tuples->getTuple(i));
       }
       nonZeroConditions->all.push_back(nonZeroCondition);
     }
@@ -208,7 +214,7 @@ Ptr<Node> TensorReader::readText(
   const Ptr<TensorNonZeroConditions> &nonZeroConditions,
   const SourceLocation &sourceLocation
 ) {
-  constexpr size_t MAX_BUFFER_SIZE(32*1024*1024);
+  const size_t MAX_BUFFER_SIZE(TensorIo::getMaxBufferSize(sizeof(F)));
   std::ifstream stream(fileName.c_str());
   if (stream.fail()) {
     std::stringstream explanation;
@@ -281,7 +287,7 @@ Ptr<Node> TensorReader::readBinary(
     );
   }
 
-  constexpr size_t MAX_BUFFER_SIZE(32*1024*1024);
+  const size_t MAX_BUFFER_SIZE(TensorIo::getMaxBufferSize(sizeof(F)));
   std::ifstream stream(fileName.c_str());
   if (stream.fail()) {
     std::stringstream explanation;
@@ -25,6 +25,9 @@ namespace cc4s {
   public:
     ALGORITHM_REGISTRAR_DECLARATION(TensorReader)
     Ptr<MapNode> run(const Ptr<MapNode> &arguments) override;
+    bool isDeterministic() override {
+      return false;
+    }
   protected:
     void readData(
       const Ptr<MapNode> &tensor,
@@ -16,6 +16,7 @@
 #include <algorithms/TensorWriter.hpp>
 
 #include <tcc/Tcc.hpp>
+#include <TensorIo.hpp>
 #include <Cc4s.hpp>
 #include <Real.hpp>
 #include <Complex.hpp>
@@ -198,7 +199,7 @@ void TensorWriter::writeText(
   const std::string &fileName,
   const SourceLocation &sourceLocation
 ) {
-  constexpr size_t MAX_BUFFER_SIZE(128*1024*1024);
+  const size_t MAX_BUFFER_SIZE(TensorIo::getMaxBufferSize(sizeof(F)));
   std::ofstream stream(fileName.c_str());
   if (stream.fail()) {
     std::stringstream explanation;
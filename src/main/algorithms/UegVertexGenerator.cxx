@@ -158,11 +158,9 @@ Ptr<MapNode> UegVertexGenerator::run(
 
   auto metaData( New<MapNode>(SOURCE_LOCATION) );
   metaData->setValue("fermiEnergy", fermiEnergy);
-  auto energiesNode( New<MapNode>(SOURCE_LOCATION) );
-  for (Natural<> i(0); i < Np; ++i) {
-    energiesNode->setValue(i, energies[i]);
-  }
-  metaData->get("energies") = energiesNode;
+  metaData->get("energies") = New<ArrayNode<Real<>>>(
+    energies, SOURCE_LOCATION
+  );
   eigenEnergies->getMetaData() = metaData;
 
   // construct the momentum transition grid
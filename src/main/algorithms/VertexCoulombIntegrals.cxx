@@ -43,18 +43,24 @@ Ptr<MapNode> VertexCoulombIntegrals::run(const Ptr<MapNode> &arguments) {
     slicedCoulombVertex->get("hh")->inspect()->getMetaData()
   );
   auto halfGrid(metaData->getValue<bool>("halfGrid", 0));
+  auto factorizedIntegrals(
+    arguments->getValue<bool>("factorizedIntegrals", false)
+  );
   if (halfGrid) {
     OUT() << "Using real Coulomb integrals" << std::endl;
-    return calculateRealIntegrals<TE>(slicedCoulombVertex);
+    return calculateRealIntegrals<TE>(slicedCoulombVertex, factorizedIntegrals);
   } else {
     OUT() << "Using complex Coulomb integrals" << std::endl;
-    return calculateComplexIntegrals<TE>(slicedCoulombVertex);
+    return calculateComplexIntegrals<TE>(
+      slicedCoulombVertex, factorizedIntegrals
+    );
   }
 }
 
 template <typename TE>
 Ptr<MapNode> VertexCoulombIntegrals::calculateRealIntegrals(
-  const Ptr<TensorSet<Complex<>,TE>> &slicedCoulombVertex
+  const Ptr<TensorSet<Complex<>,TE>> &slicedCoulombVertex,
+  const bool factorizedIntegrals
 ) {
   // get input recipes
   auto GammaGhh(slicedCoulombVertex->get("hh"));
@@ -124,12 +130,47 @@ Ptr<MapNode> VertexCoulombIntegrals::calculateRealIntegrals(
   // create result
   auto result(New<MapNode>(SOURCE_LOCATION));
   result->setPtr("coulombIntegrals", coulombIntegrals);
+
+  if (factorizedIntegrals) {
+    // stack real and imaginary parts along G, giving identical
+    // left and right factors
+    auto coulombVertexFactors(New<TensorSet<Real<>,TE>>());
+#define DEFINE_STACKED_VERTEX(SLICE) \
+    { \
+      auto lens(realGammaG##SLICE->lens); \
+      auto NG(lens[0]); \
+      lens[0] *= 2; \
+      auto stackedGammaG(Tcc<TE>::template tensor<Real<>>( \
+        lens, std::string("stackedGammaG") + #SLICE) \
+      ); \
+      stackedGammaG->getUnit() = GammaGhh->inspect()->getUnit(); \
+      auto stackedGammaGRecipe( \
+        PLAN(stackedGammaG, ( \
+          (*(*stackedGammaG)({0, 0, 0}, {NG, lens[1], lens[2]}))["Gqr"] <<= \
+            (*realGammaG##SLICE)["Gqr"], \
+          (*(*stackedGammaG)({NG, 0, 0}, lens))["Gqr"] <<= \
+            (*imagGammaG##SLICE)["Gqr"] \
+        )) \
+      ); \
+      coulombVertexFactors->get(std::string("L") + #SLICE) = \
+        stackedGammaGRecipe; \
+      coulombVertexFactors->get(std::string("R") + #SLICE) = \
+        stackedGammaGRecipe; \
+    }
+    DEFINE_STACKED_VERTEX(pp)
+    DEFINE_STACKED_VERTEX(ph)
+    DEFINE_STACKED_VERTEX(hp)
+    DEFINE_STACKED_VERTEX(hh)
+#undef DEFINE_STACKED_VERTEX
+    result->setPtr("coulombVertexFactors", coulombVertexFactors);
+  }
   return result;
 }
 
 template <typename TE>
 Ptr<MapNode> VertexCoulombIntegrals::calculateComplexIntegrals(
-  const Ptr<TensorSet<Complex<>,TE>> &slicedCoulombVertex
+  const Ptr<TensorSet<Complex<>,TE>> &slicedCoulombVertex,
+  const bool factorizedIntegrals
 ) {
   // get input recipes
   auto GammaGhh(slicedCoulombVertex->get("hh"));
@@ -193,6 +234,19 @@ Ptr<MapNode> VertexCoulombIntegrals::calculateComplexIntegrals(
   // create result
   auto result(New<MapNode>(SOURCE_LOCATION));
   result->setPtr("coulombIntegrals", coulombIntegrals);
+
+  if (factorizedIntegrals) {
+    auto coulombVertexFactors(New<TensorSet<Complex<>,TE>>());
+    coulombVertexFactors->get("Lpp") = conjTGammaGpp;
+    coulombVertexFactors->get("Lph") = conjTGammaGph;
+    coulombVertexFactors->get("Lhp") = conjTGammaGhp;
+    coulombVertexFactors->get("Lhh") = conjTGammaGhh;
+    coulombVertexFactors->get("Rpp") = GammaGpp;
+    coulombVertexFactors->get("Rph") = GammaGph;
+    coulombVertexFactors->get("Rhp") = GammaGhp;
+    coulombVertexFactors->get("Rhh") = GammaGhh;
+    result->setPtr("coulombVertexFactors", coulombVertexFactors);
+  }
   return result;
 }
 
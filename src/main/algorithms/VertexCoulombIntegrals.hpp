@@ -19,27 +19,76 @@
 #include <algorithms/Algorithm.hpp>
 #include <TensorSet.hpp>
 #include <Complex.hpp>
+#include <Cc4s.hpp>
+#include <Log.hpp>
+
+#include <string>
 
 namespace cc4s {
   /**
    * \brief Prepares all slices of the Coulomb Integrals to
    * be calculated from the Coulomb Vertex, once needed.
+   * If factorizedIntegrals is given, the factors L and R of the
+   * integrals \f$V^{pq}_{sr} = \sum_G L^G_{ps} R^G_{qr}\f$ are also
+   * provided as coulombVertexFactors, with the keys Lpp, Lph, ..., Rhh.
    */
   class VertexCoulombIntegrals: public Algorithm {
   public:
     ALGORITHM_REGISTRAR_DECLARATION(VertexCoulombIntegrals)
 
     Ptr<MapNode> run(const Ptr<MapNode> &arguments) override;
+
+    /**
+     * \brief Returns the given slice of the Coulomb integrals, e.g. "ppph",
+     * indexed with the given indices. The slice is contracted through its
+     * coulombVertexFactors rather than evaluated only if they are given
+     * and the slice does not fit into the slices share of the memory,
+     * since each contraction through the factors costs NG times the
+     * operations of a contraction with the evaluated slice. The order of
+     * the contractions is left to tcc. The factors are indexed with G,
+     * which must not occur elsewhere in the contraction.
+     **/
+    template <typename F, typename TE>
+    static Ptr<Contraction<F,TE>> getIntegrals(
+      const Ptr<TensorSet<F,TE>> &coulombIntegrals,
+      const Ptr<TensorSet<F,TE>> &coulombVertexFactors,
+      const std::string &slice, const std::string &indices
+    ) {
+      if (!coulombVertexFactors) {
+        return F(1) * (*coulombIntegrals->get(slice))[indices];
+      }
+      auto L(coulombVertexFactors->get(std::string("L") + slice[0] + slice[2]));
+      auto R(coulombVertexFactors->get(std::string("R") + slice[1] + slice[3]));
+      auto LLens(L->inspect()->getLens()), RLens(R->inspect()->getLens());
+      Natural<128> sliceSize(
+        Natural<128>(LLens[1]) * LLens[2] * RLens[1] * RLens[2] * sizeof(F)
+      );
+      Natural<128> memory(
+        Natural<128>(Cc4s::getMemoryShare(Cc4s::SLICES_MEMORY)) *
+          Cc4s::getProcessesCount()
+      );
+      if (sliceSize <= memory) {
+        return F(1) * (*coulombIntegrals->get(slice))[indices];
+      }
+      LOG() << "Contracting Coulomb integrals " << slice
+        << " through the vertex" << std::endl;
+      return
+        (*L)[std::string("G") + indices[0] + indices[2]] *
+        (*R)[std::string("G") + indices[1] + indices[3]];
+    }
+
   protected:
     template <typename TE>
     Ptr<MapNode> run(const Ptr<MapNode> &arguments);
     template <typename TE>
     Ptr<MapNode> calculateRealIntegrals(
-      const Ptr<TensorSet<Complex<>,TE>> &slicedCoulombVertex
+      const Ptr<TensorSet<Complex<>,TE>> &slicedCoulombVertex,
+      const bool factorizedIntegrals
     );
     template <typename TE>
     Ptr<MapNode> calculateComplexIntegrals(
-      const Ptr<TensorSet<Complex<>,TE>> &slicedCoulombVertex
+      const Ptr<TensorSet<Complex<>,TE>> &slicedCoulombVertex,
+      const bool factorizedIntegrals
     );
   };
 }
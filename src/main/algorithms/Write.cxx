@@ -29,10 +29,24 @@ Ptr<MapNode> Write::run(const Ptr<MapNode> &arguments) {
   auto source(arguments->get("source"));
   ASSERT_LOCATION(source, "expecting key 'source'", arguments->sourceLocation);
   auto fileName(arguments->getValue<std::string>("fileName"));
-  // TODO: use options
   auto useBinary(arguments->getValue<bool>("binary", false));
-
-  auto persistentSource(Writer(fileName, useBinary).write(source));
+  auto options(New<MapNode>(arguments->sourceLocation));
+  options->setValue(
+    "elementsType",
+    arguments->getValue<std::string>(
+      "elementsType", useBinary ? "IeeeBinaryFile" : "TextFile"
+    )
+  );
+  // absolute error bound for lossy compression, zero for lossless
+  if (arguments->isGiven("errorBound")) {
+    options->setValue(
+      "errorBound", arguments->getValue<Real<>>("errorBound")
+    );
+  }
+  // write binary elements in the background, overlapping with later steps
+  options->setValue("async", arguments->getValue<bool>("async", false));
+
+  auto persistentSource(Writer(fileName, options).write(source));
 
   // create result
   auto result(New<MapNode>(source->sourceLocation));
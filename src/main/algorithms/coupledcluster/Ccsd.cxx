@@ -40,10 +40,10 @@ std::string Ccsd<Real<>,TE>::describeOptions() {
     )
   );
   auto epsh(eigenEnergies->get("h"));
+  auto epsp(eigenEnergies->get("p"));
   auto No(epsh->inspect()->getLen(0));
-  auto integralsSliceSize(
-    this->arguments->template getValue<Natural<>>("integralsSliceSize", No)
-  );
+  auto Nv(epsp->inspect()->getLen(0));
+  auto integralsSliceSize(this->getIntegralsSliceSize(No, Nv));
   stream
     << "integralsSliceSize: " << integralsSliceSize;
   return stream.str();
@@ -58,10 +58,10 @@ std::string Ccsd<Complex<>,TE>::describeOptions() {
     )
   );
   auto epsh(eigenEnergies->get("h"));
+  auto epsp(eigenEnergies->get("p"));
   auto No(epsh->inspect()->getLen(0));
-  auto integralsSliceSize(
-    this->arguments->template getValue<Natural<>>("integralsSliceSize", No)
-  );
+  auto Nv(epsp->inspect()->getLen(0));
+  auto integralsSliceSize(this->getIntegralsSliceSize(No, Nv));
   stream
     << "integralsSliceSize: " << integralsSliceSize;
   return stream.str();
@@ -73,6 +73,67 @@ std::string Ccsd<Complex<>,TE>::describeOptions() {
 // So Hirata, et. al. Chem. Phys. Letters, 345, 475 (2001)
 //////////////////////////////////////////////////////////////////////
 
+template <typename TE>
+void Ccsd<Real<>,TE>::prepareVertex() {
+  if (realGammaGpp) return;
+  auto coulombVertex(
+    this->arguments->template getPtr<TensorSet<Complex<>,TE>>(
+      "slicedCoulombVertex"
+    )
+  );
+  auto GammaGpp(coulombVertex->get("pp"));
+  auto GammaGph(coulombVertex->get("ph"));
+  auto GammaGhh(coulombVertex->get("hh"));
+
+  //Gamma -> Real/Imag
+  auto realGpp( Tcc<TE>::template tensor<Real<>>("realGammaGpp") );
+  auto imagGpp( Tcc<TE>::template tensor<Real<>>("imagGammaGpp") );
+  auto realGph( Tcc<TE>::template tensor<Real<>>("realGammaGph") );
+  auto imagGph( Tcc<TE>::template tensor<Real<>>("imagGammaGph") );
+  auto realGhh( Tcc<TE>::template tensor<Real<>>("realGammaGhh") );
+  auto imagGhh( Tcc<TE>::template tensor<Real<>>("imagGammaGhh") );
+  realGammaGpp = PLAN(realGpp,
+    (*realGpp)["Gab"] <<= map<Real<>>(real<Complex<>>, (*GammaGpp)["Gab"])
+  );
+  imagGammaGpp = PLAN(imagGpp,
+    (*imagGpp)["Gab"] <<= map<Real<>>(imag<Complex<>>, (*GammaGpp)["Gab"])
+  );
+  realGammaGph = PLAN(realGph,
+    (*realGph)["Gai"] <<= map<Real<>>(real<Complex<>>, (*GammaGph)["Gai"])
+  );
+  imagGammaGph = PLAN(imagGph,
+    (*imagGph)["Gai"] <<= map<Real<>>(imag<Complex<>>, (*GammaGph)["Gai"])
+  );
+  realGammaGhh = PLAN(realGhh,
+    (*realGhh)["Gij"] <<= map<Real<>>(real<Complex<>>, (*GammaGhh)["Gij"])
+  );
+  imagGammaGhh = PLAN(imagGhh,
+    (*imagGhh)["Gij"] <<= map<Real<>>(imag<Complex<>>, (*GammaGhh)["Gij"])
+  );
+
+  // shapes will be assumed upon first use
+  realDressedGammaGpp = Tcc<TE>::template tensor<Real<>>("realDressedGammaGpp");
+  imagDressedGammaGpp = Tcc<TE>::template tensor<Real<>>("imagDressedGammaGpp");
+  realDressedGammaGph = Tcc<TE>::template tensor<Real<>>("realDressedGammaGph");
+  imagDressedGammaGph = Tcc<TE>::template tensor<Real<>>("imagDressedGammaGph");
+  realDressedGammaGhh = Tcc<TE>::template tensor<Real<>>("realDressedGammaGhh");
+  imagDressedGammaGhh = Tcc<TE>::template tensor<Real<>>("imagDressedGammaGhh");
+}
+
+template <typename TE>
+void Ccsd<Real<>,TE>::reserveBuffers() {
+  auto coulombVertex(
+    this->arguments->template getPtr<TensorSet<Complex<>,TE>>(
+      "slicedCoulombVertex"
+    )
+  );
+  auto GammaGpp(coulombVertex->get("pp"));
+  // real and imaginary parts of the vertex and its dressed copy
+  auto NG(GammaGpp->inspect()->getLen(0));
+  auto Nv(GammaGpp->inspect()->getLen(1));
+  this->reserveMemory(4 * NG*Nv*Nv * sizeof(Real<>));
+}
+
 template <typename TE>
 Ptr<TensorSet<Real<>,TE>> Ccsd<Real<>,TE>::getResiduum(
   const Ptr<TensorSet<Real<>,TE>> &amplitudes
@@ -107,49 +168,10 @@ Ptr<TensorSet<Real<>,TE>> Ccsd<Real<>,TE>::getResiduum(
     auto Tpphh( amplitudes->get("pphh") );
     Tph->inspect()->setName("Tph"); Tpphh->inspect()->setName("Tpphh");
 
-    auto coulombVertex(
-      this->arguments->template getPtr<TensorSet<Complex<>,TE>>(
-        "slicedCoulombVertex"
-      )
-    );
-    auto GammaGpp(coulombVertex->get("pp"));
-    auto GammaGph(coulombVertex->get("ph"));
-    auto GammaGhh(coulombVertex->get("hh"));
-
     auto Vhhhh(coulombIntegrals->get("hhhh"));
     auto Vhhhp(coulombIntegrals->get("hhhp"));
 
-    //Gamma -> Real/Imag
-    auto realGammaGpp( Tcc<TE>::template tensor<Real<>>("realGammaGpp") );
-    auto imagGammaGpp( Tcc<TE>::template tensor<Real<>>("imagGammaGpp") );
-    auto realGammaGph( Tcc<TE>::template tensor<Real<>>("realGammaGph") );
-    auto imagGammaGph( Tcc<TE>::template tensor<Real<>>("imagGammaGph") );
-    auto realGammaGhh( Tcc<TE>::template tensor<Real<>>("realGammaGhh") );
-    auto imagGammaGhh( Tcc<TE>::template tensor<Real<>>("imagGammaGhh") );
-    COMPILE(
-      (*realGammaGpp)["Gab"] <<= map<Real<>>(real<Complex<>>, (*GammaGpp)["Gab"] ),
-      (*imagGammaGpp)["Gab"] <<= map<Real<>>(imag<Complex<>>, (*GammaGpp)["Gab"] ),
-      (*realGammaGph)["Gai"] <<= map<Real<>>(real<Complex<>>, (*GammaGph)["Gai"] ),
-      (*imagGammaGph)["Gai"] <<= map<Real<>>(imag<Complex<>>, (*GammaGph)["Gai"] ),
-      (*realGammaGhh)["Gij"] <<= map<Real<>>(real<Complex<>>, (*GammaGhh)["Gij"] ),
-      (*imagGammaGhh)["Gij"] <<= map<Real<>>(imag<Complex<>>, (*GammaGhh)["Gij"] )
-    )->execute();
-    auto realDressedGammaGpp(
-      Tcc<TE>::template tensor<Real<>>("realDressedGammaGpp")
-    );
-    auto imagDressedGammaGpp(
-      Tcc<TE>::template tensor<Real<>>("imagDressedGammaGpp")
-    );
-    auto realDressedGammaGph(
-      Tcc<TE>::template tensor<Real<>>("realDressedGammaGph")
-    );
-    auto imagDressedGammaGph(
-      Tcc<TE>::template tensor<Real<>>("imagDressedGammaGph")
-    );
-    auto realDressedGammaGhh(
-      Tcc<TE>::template tensor<Real<>>("realDressedGammaGhh")
-    );
-    auto imagDressedGammaGhh( Tcc<TE>::template tensor<Real<>>("imagDressedGammaGhh") );
+    prepareVertex();
     // define intermediates
     auto Kac( Tcc<TE>::template tensor<Real<>>("Kac") ); //kappa_ac
     auto Kki( Tcc<TE>::template tensor<Real<>>("Kki") ); //kappa_ki
@@ -284,10 +306,8 @@ Ptr<TensorSet<Real<>,TE>> Ccsd<Real<>,TE>::getResiduum(
       Natural<> Nv(realDressedGammaGpp->lens[1]);
       Natural<> NG(realDressedGammaGpp->lens[0]);
       Natural<> No(Rpphh->inspect()->getLen(2));
-      Natural<> sliceSize(
-        this->arguments->template getValue<Natural<>>("integralsSliceSize", No)
-      );
-      Natural<> numberSlices(Natural<>(ceil(1.0*Nv/sliceSize)));
+      Natural<> sliceSize(this->getIntegralsSliceSize(No, Nv));
+      Natural<> numberSlices((Nv + sliceSize-1) / sliceSize);
       std::vector<Ptr<Tensor<Real<>, TE>>> realSlicedGammaGpp;
       std::vector<Ptr<Tensor<Real<>, TE>>> imagSlicedGammaGpp;
       //Slice GammaGab and store it in a vector
@@ -310,7 +330,6 @@ Ptr<TensorSet<Real<>,TE>> Ccsd<Real<>,TE>::getResiduum(
       for (Natural<> n(m); n < numberSlices; n++){
         auto Vxycd( Tcc<TE>::template tensor<Real<>>("Vxycd") );
         auto Rxyij( Tcc<TE>::template tensor<Real<>>("Rxyij") );
-        auto Ryxji( Tcc<TE>::template tensor<Real<>>("Ryxji") );
         Natural<> a(n*sliceSize); Natural<> b(m*sliceSize);
         Natural<> Nx(realSlicedGammaGpp[n]->lens[1]);
         Natural<> Ny(realSlicedGammaGpp[m]->lens[1]);
@@ -321,10 +340,11 @@ Ptr<TensorSet<Real<>,TE>> Ccsd<Real<>,TE>::getResiduum(
             (*imagSlicedGammaGpp[n])["Gxc"] * (*imagSlicedGammaGpp[m])["Gyd"],
           (*Rxyij)["xyij"] <<= (*Vxycd)["xycd"] * (*Xabij)["cdij"],
           (*(*Rpphh)({a, b, 0, 0},{a+Nx, b+Ny, No, No}))["xyij"] += (*Rxyij)["xyij"],
-          // if a>b: add the same slice at (b,a,j,i):
+          // if a>b: add the same slice transposed at (b,a,j,i)
           (a>b) ? (
-            (*Ryxji)["yxji"] <<= (*Rxyij)["xyij"],
-            (*(*Rpphh)({b, a, 0, 0},{b+Ny, a+Nx, No, No}))["xyij"] += (*Ryxji)["xyij"]
+            Tcc<TE>::sequence(),
+            (*(*Rpphh)({b, a, 0, 0},{b+Ny, a+Nx, No, No}))["yxji"] +=
+              (*Rxyij)["xyij"]
           ) : (
             Tcc<TE>::sequence()
           )
@@ -378,6 +398,57 @@ Ptr<TensorSet<Real<>,TE>> Ccsd<Real<>,TE>::getResiduum(
 }
 
 
+template <typename TE>
+void Ccsd<Complex<>,TE>::prepareVertex() {
+  if (cTGammaGpp) return;
+  auto coulombVertex(
+    this->arguments->template getPtr<TensorSet<Complex<>,TE>>(
+      "slicedCoulombVertex"
+    )
+  );
+  auto GammaGpp(coulombVertex->get("pp"));
+  auto GammaGph(coulombVertex->get("ph"));
+  auto GammaGhp(coulombVertex->get("hp"));
+  auto GammaGhh(coulombVertex->get("hh"));
+
+  auto cTGpp( Tcc<TE>::template tensor<Complex<>>("cTGammaGpp") );
+  auto cTGhp( Tcc<TE>::template tensor<Complex<>>("cTGammaGhp") );
+  auto cTGph( Tcc<TE>::template tensor<Complex<>>("cTGammaGph") );
+  auto cTGhh( Tcc<TE>::template tensor<Complex<>>("cTGammaGhh") );
+  cTGammaGpp = PLAN(cTGpp,
+    (*cTGpp)["Gab"] <<= map<Complex<>>(conj<Complex<>>, (*GammaGpp)["Gba"])
+  );
+  cTGammaGhp = PLAN(cTGhp,
+    (*cTGhp)["Gia"] <<= map<Complex<>>(conj<Complex<>>, (*GammaGph)["Gai"])
+  );
+  cTGammaGph = PLAN(cTGph,
+    (*cTGph)["Gai"] <<= map<Complex<>>(conj<Complex<>>, (*GammaGhp)["Gia"])
+  );
+  cTGammaGhh = PLAN(cTGhh,
+    (*cTGhh)["Gij"] <<= map<Complex<>>(conj<Complex<>>, (*GammaGhh)["Gji"])
+  );
+
+  // shapes will be assumed upon first use
+  cTDressedGammaGph = Tcc<TE>::template tensor<Complex<>>("cTDressedGammaGph");
+  cTDressedGammaGpp = Tcc<TE>::template tensor<Complex<>>("cTDressedGammaGpp");
+  dressedGammaGhh = Tcc<TE>::template tensor<Complex<>>("dressedGammaGhh");
+  dressedGammaGpp = Tcc<TE>::template tensor<Complex<>>("dressedGammaGpp");
+}
+
+template <typename TE>
+void Ccsd<Complex<>,TE>::reserveBuffers() {
+  auto coulombVertex(
+    this->arguments->template getPtr<TensorSet<Complex<>,TE>>(
+      "slicedCoulombVertex"
+    )
+  );
+  auto GammaGpp(coulombVertex->get("pp"));
+  // conjugate transposed vertex and its two dressed copies
+  auto NG(GammaGpp->inspect()->getLen(0));
+  auto Nv(GammaGpp->inspect()->getLen(1));
+  this->reserveMemory(3 * NG*Nv*Nv * sizeof(Complex<>));
+}
+
 template <typename TE>
 Ptr<TensorSet<Complex<>,TE>> Ccsd<Complex<>,TE>::getResiduum(
   const Ptr<TensorSet<Complex<>,TE>> &amplitudes
@@ -424,20 +495,7 @@ Ptr<TensorSet<Complex<>,TE>> Ccsd<Complex<>,TE>::getResiduum(
     auto GammaGhp(coulombVertex->get("hp"));
     auto GammaGhh(coulombVertex->get("hh"));
 
-    auto cTGammaGph( Tcc<TE>::template tensor<Complex<>>("cTGammaGph"));
-    auto cTGammaGhp( Tcc<TE>::template tensor<Complex<>>("cTGammaGhp"));
-    auto cTGammaGpp( Tcc<TE>::template tensor<Complex<>>("cTGammaGpp"));
-    auto cTGammaGhh( Tcc<TE>::template tensor<Complex<>>("cTGammaGhh"));
-    COMPILE(
-      (*cTGammaGpp)["Gab"] <<= map<Complex<>>(conj<Complex<>>, (*GammaGpp)["Gba"]),
-      (*cTGammaGhp)["Gia"] <<= map<Complex<>>(conj<Complex<>>, (*GammaGph)["Gai"]),
-      (*cTGammaGph)["Gai"] <<= map<Complex<>>(conj<Complex<>>, (*GammaGhp)["Gia"]),
-      (*cTGammaGhh)["Gij"] <<= map<Complex<>>(conj<Complex<>>, (*GammaGhh)["Gji"])
-    )->execute();
-    auto cTDressedGammaGph( Tcc<TE>::template tensor<Complex<>>("cTDressedGammaGph"));
-    auto cTDressedGammaGpp( Tcc<TE>::template tensor<Complex<>>("cTDressedGammaGpp"));
-    auto dressedGammaGhh( Tcc<TE>::template tensor<Complex<>>("dressedGammaGhh"));
-    auto dressedGammaGpp( Tcc<TE>::template tensor<Complex<>>("dressedGammaGpp"));
+    prepareVertex();
 
     auto Vphhp(coulombIntegrals->get("phhp"));
     auto Vhhpp(coulombIntegrals->get("hhpp"));
@@ -547,13 +605,11 @@ Ptr<TensorSet<Complex<>,TE>> Ccsd<Complex<>,TE>::getResiduum(
     )->execute();
 
     if (ppl) {
-      Natural<> NG(cTGammaGpp->getLen(0));
+      Natural<> NG(GammaGpp->inspect()->getLen(0));
       Natural<> Nv(Rpphh->inspect()->getLen(0));
       Natural<> No(Rpphh->inspect()->getLen(2));
-      Natural<> sliceSize(
-        this->arguments->template getValue<Natural<>>("integralsSliceSize", No)
-      );
-      Natural<> numberSlices(Natural<>(ceil(1.0*Nv/sliceSize)));
+      Natural<> sliceSize(this->getIntegralsSliceSize(No, Nv));
+      Natural<> numberSlices((Nv + sliceSize-1) / sliceSize);
       std::vector<Ptr<Tensor<Complex<>, TE>>> cTSlicedGammaGpp;
       std::vector<Ptr<Tensor<Complex<>, TE>>>   SlicedGammaGpp;
       COMPILE(
@@ -580,7 +636,6 @@ Ptr<TensorSet<Complex<>,TE>> Ccsd<Complex<>,TE>::getResiduum(
       for (Natural<> n(m); n < numberSlices; n++){
         auto Vxycd( Tcc<TE>::template tensor<Complex<>>("Vxycd") );
         auto Rxyij( Tcc<TE>::template tensor<Complex<>>("Rxyij") );
-        auto Ryxji( Tcc<TE>::template tensor<Complex<>>("Ryxji") );
         Natural<> a(n*sliceSize); Natural<> b(m*sliceSize);
         Natural<> Nx(cTSlicedGammaGpp[n]->lens[1]);
         Natural<> Ny(SlicedGammaGpp[m]->lens[1]);
@@ -589,10 +644,11 @@ Ptr<TensorSet<Complex<>,TE>> Ccsd<Complex<>,TE>::getResiduum(
             (*cTSlicedGammaGpp[n])["Gxc"] * (*SlicedGammaGpp[m])["Gyd"],
           (*Rxyij)["xyij"] <<= (*Vxycd)["xycd"] * (*Xabij)["cdij"],
           (*(*Rpphh)({a, b, 0, 0},{a+Nx, b+Ny, No, No}))["xyij"] += (*Rxyij)["xyij"],
-          // if a>b: add the same slice at (b,a,j,i):
+          // if a>b: add the same slice transposed at (b,a,j,i)
           (a>b) ? (
-            (*Ryxji)["yxji"] <<= (*Rxyij)["xyij"],
-            (*(*Rpphh)({b, a, 0, 0},{b+Ny, a+Nx, No, No}))["xyij"] += (*Ryxji)["xyij"]
+            Tcc<TE>::sequence(),
+            (*(*Rpphh)({b, a, 0, 0},{b+Ny, a+Nx, No, No}))["yxji"] +=
+              (*Rxyij)["xyij"]
           ) : (
             Tcc<TE>::sequence()
           )
@@ -34,6 +34,7 @@ namespace cc4s {
     Ccsd(
       const Ptr<MapNode> &arguments
     ): CoupledClusterMethod<Real<>,TE>(arguments) {
+      reserveBuffers();
     }
     std::string getName() override { return "Ccsd"; } \
     static CoupledClusterMethodRegistrar<
@@ -50,6 +51,30 @@ namespace cc4s {
     Ptr<TensorSet<Real<>,TE>> getResiduum(
       const Ptr<TensorSet<Real<>,TE>> &amplitudes
     ) override;
+
+  protected:
+    /**
+     * \brief Plans the real and imaginary parts of the sliced Coulomb
+     * vertex and allocates the dressed vertex buffers upon first call.
+     * The parts are only recomputed if the vertex changes.
+     **/
+    void prepareVertex();
+    /**
+     * \brief Reserves the memory of the buffers allocated by
+     * prepareVertex, such that the slices are sized accordingly.
+     **/
+    void reserveBuffers();
+
+    Ptr<TensorExpression<Real<>,TE>> realGammaGpp, imagGammaGpp;
+    Ptr<TensorExpression<Real<>,TE>> realGammaGph, imagGammaGph;
+    Ptr<TensorExpression<Real<>,TE>> realGammaGhh, imagGammaGhh;
+    /**
+     * \brief Vertex dressed with the singles amplitudes, overwritten
+     * in each iteration.
+     **/
+    Ptr<Tensor<Real<>,TE>> realDressedGammaGpp, imagDressedGammaGpp;
+    Ptr<Tensor<Real<>,TE>> realDressedGammaGph, imagDressedGammaGph;
+    Ptr<Tensor<Real<>,TE>> realDressedGammaGhh, imagDressedGammaGhh;
   };
 
   template <typename TE>
@@ -58,6 +83,7 @@ namespace cc4s {
     Ccsd(
       const Ptr<MapNode> &arguments
     ): CoupledClusterMethod<Complex<>,TE>(arguments) {
+      reserveBuffers();
     }
     std::string getName() override { return "Ccsd"; } \
     static CoupledClusterMethodRegistrar<
@@ -74,6 +100,28 @@ namespace cc4s {
     Ptr<TensorSet<Complex<>,TE>> getResiduum(
       const Ptr<TensorSet<Complex<>,TE>> &amplitudes
     ) override;
+
+  protected:
+    /**
+     * \brief Plans the conjugate transposed parts of the sliced Coulomb
+     * vertex and allocates the dressed vertex buffers upon first call.
+     * The parts are only recomputed if the vertex changes.
+     **/
+    void prepareVertex();
+    /**
+     * \brief Reserves the memory of the buffers allocated by
+     * prepareVertex, such that the slices are sized accordingly.
+     **/
+    void reserveBuffers();
+
+    Ptr<TensorExpression<Complex<>,TE>> cTGammaGpp, cTGammaGph;
+    Ptr<TensorExpression<Complex<>,TE>> cTGammaGhp, cTGammaGhh;
+    /**
+     * \brief Vertex dressed with the singles amplitudes, overwritten
+     * in each iteration.
+     **/
+    Ptr<Tensor<Complex<>,TE>> cTDressedGammaGph, cTDressedGammaGpp;
+    Ptr<Tensor<Complex<>,TE>> dressedGammaGhh, dressedGammaGpp;
   };
 }
 
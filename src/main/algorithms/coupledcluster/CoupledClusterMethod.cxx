@@ -15,17 +15,56 @@
 
 #include <algorithms/coupledcluster/CoupledClusterMethod.hpp>
 #include <algorithms/Algorithm.hpp>
+#include <Cc4s.hpp>
+
+#include <cmath>
+#include <algorithm>
 
 using namespace cc4s;
 
 template <typename F, typename TE>
 CoupledClusterMethod<F,TE>::CoupledClusterMethod(
   const Ptr<MapNode> &arguments_
-): arguments(arguments_) {
+): arguments(arguments_), reservedMemory(0), integralsSliceSize(0) {
 }
 
 template <typename F, typename TE>
 CoupledClusterMethod<F,TE>::~CoupledClusterMethod() {
+  Cc4s::releaseMemory(reservedMemory);
+}
+
+template <typename F, typename TE>
+void CoupledClusterMethod<F,TE>::reserveMemory(const Natural<> bytes) {
+  auto bytesPerRank(bytes / Cc4s::getProcessesCount());
+  Cc4s::reserveMemory(bytesPerRank);
+  reservedMemory += bytesPerRank;
+}
+
+template <typename F, typename TE>
+Natural<> CoupledClusterMethod<F,TE>::getIntegralsSliceSize(
+  const Natural<> No, const Natural<> Nv
+) {
+  if (integralsSliceSize > 0) return integralsSliceSize;
+  integralsSliceSize =
+    arguments->template getValue<Natural<>>("integralsSliceSize", 0);
+  if (integralsSliceSize > 0) return integralsSliceSize;
+  // Vxycd and Rxyij for slices x,y of the virtual orbitals
+  auto memory(
+    Real<>(Cc4s::getMemoryShare(Cc4s::SLICES_MEMORY)) *
+      Cc4s::getProcessesCount()
+  );
+  auto sliceSize(
+    Natural<>(std::sqrt(memory / sizeof(F) / (Nv*Nv + 2*No*No)))
+  );
+  sliceSize = std::max(Natural<>(1), std::min(sliceSize, Nv));
+  if (Nv > 0) {
+    // balance the slices so that the last one is not much smaller,
+    // which would cost a full pass over the vertex for little work
+    Natural<> slicesCount((Nv + sliceSize-1) / sliceSize);
+    sliceSize = (Nv + slicesCount-1) / slicesCount;
+  }
+  integralsSliceSize = sliceSize;
+  return integralsSliceSize;
 }
 
 // instantiate
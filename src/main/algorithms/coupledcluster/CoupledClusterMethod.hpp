@@ -50,7 +50,34 @@ namespace cc4s {
       const Ptr<TensorSet<F,TE>> &amplitudes
     ) = 0;
 
+    /**
+     * \brief Returns the integralsSliceSize argument or, if not given,
+     * the largest number of virtual orbitals per slice such that the
+     * particle-particle ladder integrals of two slices and their
+     * contribution to the residuum fit into the slices share of the
+     * memory of all ranks, but at most Nv. The automatic slice size is
+     * balanced such that all slices have nearly the same size. It is
+     * determined upon first call and kept for subsequent calls.
+     **/
+    Natural<> getIntegralsSliceSize(const Natural<> No, const Natural<> Nv);
+
+    /**
+     * \brief Reserves the given bytes of all ranks in the memory budget
+     * for buffers kept across iterations. They are released when the
+     * method is destroyed.
+     **/
+    void reserveMemory(const Natural<> bytes);
+
     Ptr<MapNode> arguments;
+    /**
+     * \brief Bytes per rank reserved in the memory budget.
+     **/
+    Natural<> reservedMemory;
+    /**
+     * \brief Number of virtual orbitals per slice of the ladder integrals,
+     * zero until determined by getIntegralsSliceSize.
+     **/
+    Natural<> integralsSliceSize;
   };
 
   template <typename F, typename TE>
@@ -18,8 +18,470 @@
 #include<atrip/Slice.hpp>
 #include<atrip/Blas.hpp>
 
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__INTEL_COMPILER) \
+  && !defined(ATRIP_NO_SIMD)
+#  define ATRIP_ENERGY_SIMD
+#  include <immintrin.h>
+#endif
+
 namespace atrip {
 
+  namespace energy {
+
+    // One (j,k) row of a tuple's energy, i.e. the elements i in
+    // [istart, istart + n). The index permutations ijk and ikj of T and Z
+    // are contiguous in i, jik and kij have stride No and jki and kji have
+    // stride No*No. The Same kernels use U, X, Y and A, D, E only.
+    template <typename F>
+    struct Row {
+      size_t n, No;
+      // epsabc - ej - ek and epsi at istart
+      F epsjk;
+      F const *epsi;
+      // whether the first element is the diagonal i == j
+      bool diagonal;
+      F const *U, *V, *W, *X, *Y, *Z;
+      F const *A, *B, *C, *D, *E, *_F;
+
+      Row part(const size_t begin, const size_t end) const {
+        const size_t s(No*begin), ss(No*No*begin);
+        return { end - begin, No, epsjk, epsi + begin
+               , diagonal && begin == 0
+               , U + begin, V + begin, W + s, X + ss, Y + s, Z + ss
+               , A + begin, B + begin, C + s, D + ss, E + s, _F + ss
+               };
+      }
+    };
+
+    template <typename F>
+    Row<F> makeRow
+      ( const F epsabc
+      , std::vector<F> const& epsi
+      , F const* t
+      , F const* z
+      , const size_t istart
+      , const size_t iend
+      , const size_t j
+      , const size_t k
+      ) {
+      const size_t No(epsi.size()), NoNo(No*No), i(istart);
+      return { iend - istart, No, epsabc - epsi[j] - epsi[k]
+             , epsi.data() + istart, istart == j
+             , z + i + No*j + NoNo*k, z + i + No*k + NoNo*j
+             , z + j + No*i + NoNo*k, z + j + No*k + NoNo*i
+             , z + k + No*i + NoNo*j, z + k + No*j + NoNo*i
+             , t + i + No*j + NoNo*k, t + i + No*k + NoNo*j
+             , t + j + No*i + NoNo*k, t + j + No*k + NoNo*i
+             , t + k + No*i + NoNo*j, t + k + No*j + NoNo*i
+             };
+    }
+
+    template <typename F>
+    F distinctRowScalar(Row<F> const& r) {
+      const size_t No(r.No), NoNo(No*No);
+      F energy(0.);
+      for (size_t i(0); i < r.n; i++) {
+        const F
+            facij = r.diagonal && i == 0 ? F(0.5) : F(1.0)
+          , denominator(r.epsjk - r.epsi[i])
+          , U(r.U[i]), V(r.V[i]), W(r.W[No*i])
+          , X(r.X[NoNo*i]), Y(r.Y[No*i]), Z(r.Z[NoNo*i])
+          , A(maybeConjugate<F>(r.A[i]))
+          , B(maybeConjugate<F>(r.B[i]))
+          , C(maybeConjugate<F>(r.C[No*i]))
+          , D(maybeConjugate<F>(r.D[NoNo*i]))
+          , E(maybeConjugate<F>(r.E[No*i]))
+          , _F(maybeConjugate<F>(r._F[NoNo*i]))
+          , value
+            = F(3.0) * ( A * U
+                       + B * V
+                       + C * W
+                       + D * X
+                       + E * Y
+                       + _F * Z )
+            + ( ( U + X + Y )
+              - F(2.0) * ( V + W + Z )
+              ) * ( A + D + E )
+            + ( ( V + W + Z )
+              - F(2.0) * ( U + X + Y )
+              ) * ( B + C + _F )
+          ;
+        energy += value / denominator * facij;
+      }
+      return energy;
+    }
+
+    template <typename F>
+    F sameRowScalar(Row<F> const& r) {
+      const size_t No(r.No), NoNo(No*No);
+      F energy(0.);
+      for (size_t i(0); i < r.n; i++) {
+        const F
+            facij = r.diagonal && i == 0 ? F(0.5) : F(1.0)
+          , denominator(r.epsjk - r.epsi[i])
+          , U(r.U[i]), V(r.X[NoNo*i]), W(r.Y[No*i])
+          , A(maybeConjugate<F>(r.A[i]))
+          , B(maybeConjugate<F>(r.D[NoNo*i]))
+          , C(maybeConjugate<F>(r.E[No*i]))
+          , value
+            = F(3.0) * ( A * U
+                       + B * V
+                       + C * W
+                       )
+            - ( A + B + C ) * ( U + V + W )
+          ;
+        energy += value / denominator * facij;
+      }
+      return energy;
+    }
+
+    enum class Isa { Scalar, Avx2, Avx512 };
+
+    // Instruction set used for the real rows, detected at the first call.
+    // It may be lowered, e.g. for benchmarking, but never raised.
+    inline Isa& isa() {
+#if defined(ATRIP_ENERGY_SIMD)
+      static Isa selected([] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return Isa::Avx512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+          return Isa::Avx2;
+        return Isa::Scalar;
+      }());
+#else
+      static Isa selected(Isa::Scalar);
+#endif
+      return selected;
+    }
+
+    // Sums the rows of all tiles i >= j >= k with the given row kernel.
+    template <typename F, F (*row)(Row<F> const&)>
+    F sumRows
+      ( const F epsabc
+      , std::vector<F> const& epsi
+      , std::vector<F> const& Tijk_
+      , std::vector<F> const& Zijk_
+      ) {
+      constexpr size_t blockSize=16;
+      F energy(0.);
+      const size_t No = epsi.size();
+      for (size_t kk=0; kk<No; kk+=blockSize){
+        const size_t kend( std::min(No, kk+blockSize) );
+        for (size_t jj(kk); jj<No; jj+=blockSize){
+          const size_t jend( std::min( No, jj+blockSize) );
+          for (size_t ii(jj); ii<No; ii+=blockSize){
+            const size_t iend( std::min( No, ii+blockSize) );
+            for (size_t k(kk); k < kend; k++){
+              const size_t jstart = jj > k ? jj : k;
+              for (size_t j(jstart); j < jend; j++){
+                F const facjk = j == k ? F(0.5) : F(1.0);
+                const size_t istart = ii > j ? ii : j;
+                energy += F(2.0) * facjk * row(makeRow<F>
+                  ( epsabc, epsi, Tijk_.data(), Zijk_.data()
+                  , istart, iend, j, k ));
+              } // j
+            } // k
+          } // ii
+        } // jj
+      } // kk
+      return energy;
+    }
+
+    template <typename F>
+    F distinct
+      ( const F epsabc
+      , std::vector<F> const& epsi
+      , std::vector<F> const& Tijk_
+      , std::vector<F> const& Zijk_
+      ) {
+      return sumRows<F, distinctRowScalar<F>>(epsabc, epsi, Tijk_, Zijk_);
+    }
+
+    template <typename F>
+    F same
+      ( const F epsabc
+      , std::vector<F> const& epsi
+      , std::vector<F> const& Tijk_
+      , std::vector<F> const& Zijk_
+      ) {
+      return sumRows<F, sameRowScalar<F>>(epsabc, epsi, Tijk_, Zijk_);
+    }
+
+#if defined(ATRIP_ENERGY_SIMD)
+    // The vector kernels load the contiguous permutations directly and
+    // gather the strided ones. The inverse denominators of each vector
+    // are computed once and the diagonal element i == j is halved there.
+    __attribute__((target("avx2,fma")))
+    inline double distinctRowAvx2(Row<double> const& r) {
+      const long long No(r.No), NoNo(No*No);
+      const __m256i
+          sNo(_mm256_set_epi64x(3*No, 2*No, No, 0))
+        , sNoNo(_mm256_set_epi64x(3*NoNo, 2*NoNo, NoNo, 0));
+      const __m256d
+          three(_mm256_set1_pd(3.0)), two(_mm256_set1_pd(2.0))
+        , one(_mm256_set1_pd(1.0)), epsjk(_mm256_set1_pd(r.epsjk));
+      __m256d
+          acc(_mm256_setzero_pd())
+        , facij(_mm256_set_pd(1.0, 1.0, 1.0, r.diagonal ? 0.5 : 1.0));
+      size_t i(0);
+      for (; i + 4 <= r.n; i += 4) {
+        const __m256d
+            U(_mm256_loadu_pd(r.U + i)), V(_mm256_loadu_pd(r.V + i))
+          , W(_mm256_i64gather_pd(r.W + No*i, sNo, 8))
+          , X(_mm256_i64gather_pd(r.X + NoNo*i, sNoNo, 8))
+          , Y(_mm256_i64gather_pd(r.Y + No*i, sNo, 8))
+          , Z(_mm256_i64gather_pd(r.Z + NoNo*i, sNoNo, 8))
+          , A(_mm256_loadu_pd(r.A + i)), B(_mm256_loadu_pd(r.B + i))
+          , C(_mm256_i64gather_pd(r.C + No*i, sNo, 8))
+          , D(_mm256_i64gather_pd(r.D + NoNo*i, sNoNo, 8))
+          , E(_mm256_i64gather_pd(r.E + No*i, sNo, 8))
+          , _F(_mm256_i64gather_pd(r._F + NoNo*i, sNoNo, 8))
+          , inverse(_mm256_div_pd(facij,
+              _mm256_sub_pd(epsjk, _mm256_loadu_pd(r.epsi + i))))
+          , s(_mm256_fmadd_pd(A, U,
+              _mm256_fmadd_pd(B, V,
+              _mm256_fmadd_pd(C, W,
+              _mm256_fmadd_pd(D, X,
+              _mm256_fmadd_pd(E, Y,
+              _mm256_mul_pd(_F, Z)))))))
+          , p(_mm256_add_pd(_mm256_add_pd(U, X), Y))
+          , q(_mm256_add_pd(_mm256_add_pd(V, W), Z))
+          , a(_mm256_add_pd(_mm256_add_pd(A, D), E))
+          , b(_mm256_add_pd(_mm256_add_pd(B, C), _F))
+          , value(_mm256_fmadd_pd(three, s,
+                  _mm256_fmadd_pd(_mm256_fnmadd_pd(two, q, p), a,
+                  _mm256_mul_pd(_mm256_fnmadd_pd(two, p, q), b))))
+          ;
+        acc = _mm256_fmadd_pd(value, inverse, acc);
+        facij = one;
+      }
+      double lanes[4];
+      _mm256_storeu_pd(lanes, acc);
+      return lanes[0] + lanes[1] + lanes[2] + lanes[3]
+           + (i < r.n ? distinctRowScalar<double>(r.part(i, r.n)) : 0.0);
+    }
+
+    __attribute__((target("avx2,fma")))
+    inline double sameRowAvx2(Row<double> const& r) {
+      const long long No(r.No), NoNo(No*No);
+      const __m256i
+          sNo(_mm256_set_epi64x(3*No, 2*No, No, 0))
+        , sNoNo(_mm256_set_epi64x(3*NoNo, 2*NoNo, NoNo, 0));
+      const __m256d
+          three(_mm256_set1_pd(3.0))
+        , one(_mm256_set1_pd(1.0)), epsjk(_mm256_set1_pd(r.epsjk));
+      __m256d
+          acc(_mm256_setzero_pd())
+        , facij(_mm256_set_pd(1.0, 1.0, 1.0, r.diagonal ? 0.5 : 1.0));
+      size_t i(0);
+      for (; i + 4 <= r.n; i += 4) {
+        const __m256d
+            U(_mm256_loadu_pd(r.U + i))
+          , V(_mm256_i64gather_pd(r.X + NoNo*i, sNoNo, 8))
+          , W(_mm256_i64gather_pd(r.Y + No*i, sNo, 8))
+          , A(_mm256_loadu_pd(r.A + i))
+          , B(_mm256_i64gather_pd(r.D + NoNo*i, sNoNo, 8))
+          , C(_mm256_i64gather_pd(r.E + No*i, sNo, 8))
+          , inverse(_mm256_div_pd(facij,
+              _mm256_sub_pd(epsjk, _mm256_loadu_pd(r.epsi + i))))
+          , s(_mm256_fmadd_pd(A, U,
+              _mm256_fmadd_pd(B, V,
+              _mm256_mul_pd(C, W))))
+          , value(_mm256_fmsub_pd(three, s,
+                  _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(A, B), C),
+                                _mm256_add_pd(_mm256_add_pd(U, V), W))))
+          ;
+        acc = _mm256_fmadd_pd(value, inverse, acc);
+        facij = one;
+      }
+      double lanes[4];
+      _mm256_storeu_pd(lanes, acc);
+      return lanes[0] + lanes[1] + lanes[2] + lanes[3]
+           + (i < r.n ? sameRowScalar<double>(r.part(i, r.n)) : 0.0);
+    }
+
+    // sums the lanes through their halves, since _mm512_reduce_add_pd
+    // and the unmasked _mm512_extractf64x4_pd trigger -Wmaybe-uninitialized
+    // with GCC 12. The full mask compiles to the plain vextractf64x4.
+    __attribute__((target("avx512f")))
+    inline double reduceAddAvx512(const __m512d x) {
+      const __m256d
+        half(_mm256_add_pd( _mm512_maskz_extractf64x4_pd(0xff, x, 0)
+                          , _mm512_maskz_extractf64x4_pd(0xff, x, 1)));
+      const __m128d
+        quarter(_mm_add_pd( _mm256_extractf128_pd(half, 0)
+                          , _mm256_extractf128_pd(half, 1)));
+      return _mm_cvtsd_f64(_mm_add_sd(quarter, _mm_unpackhi_pd(quarter, quarter)));
+    }
+
+    __attribute__((target("avx512f")))
+    inline double distinctRowAvx512(Row<double> const& r) {
+      const long long No(r.No), NoNo(No*No);
+      const __m512i
+          sNo(_mm512_set_epi64(7*No, 6*No, 5*No, 4*No, 3*No, 2*No, No, 0))
+        , sNoNo(_mm512_set_epi64( 7*NoNo, 6*NoNo, 5*NoNo, 4*NoNo
+                                , 3*NoNo, 2*NoNo, NoNo, 0));
+      const __m512d
+          three(_mm512_set1_pd(3.0)), two(_mm512_set1_pd(2.0))
+        , one(_mm512_set1_pd(1.0)), half(_mm512_set1_pd(0.5))
+        , epsjk(_mm512_set1_pd(r.epsjk));
+      const __m512d zero(_mm512_setzero_pd());
+      __m512d acc(zero);
+      for (size_t i(0); i < r.n; i += 8) {
+        const __mmask8 m(r.n - i < 8 ? (1u << (r.n - i)) - 1 : 0xff);
+        const __m512d
+            U(_mm512_maskz_loadu_pd(m, r.U + i)), V(_mm512_maskz_loadu_pd(m, r.V + i))
+          , W(_mm512_mask_i64gather_pd(zero, m, sNo, r.W + No*i, 8))
+          , X(_mm512_mask_i64gather_pd(zero, m, sNoNo, r.X + NoNo*i, 8))
+          , Y(_mm512_mask_i64gather_pd(zero, m, sNo, r.Y + No*i, 8))
+          , Z(_mm512_mask_i64gather_pd(zero, m, sNoNo, r.Z + NoNo*i, 8))
+          , A(_mm512_maskz_loadu_pd(m, r.A + i)), B(_mm512_maskz_loadu_pd(m, r.B + i))
+          , C(_mm512_mask_i64gather_pd(zero, m, sNo, r.C + No*i, 8))
+          , D(_mm512_mask_i64gather_pd(zero, m, sNoNo, r.D + NoNo*i, 8))
+          , E(_mm512_mask_i64gather_pd(zero, m, sNo, r.E + No*i, 8))
+          , _F(_mm512_mask_i64gather_pd(zero, m, sNoNo, r._F + NoNo*i, 8))
+          , inverse(_mm512_maskz_div_pd(m, one,
+              _mm512_sub_pd(epsjk, _mm512_maskz_loadu_pd(m, r.epsi + i))))
+          , s(_mm512_fmadd_pd(A, U,
+              _mm512_fmadd_pd(B, V,
+              _mm512_fmadd_pd(C, W,
+              _mm512_fmadd_pd(D, X,
+              _mm512_fmadd_pd(E, Y,
+              _mm512_mul_pd(_F, Z)))))))
+          , p(_mm512_add_pd(_mm512_add_pd(U, X), Y))
+          , q(_mm512_add_pd(_mm512_add_pd(V, W), Z))
+          , a(_mm512_add_pd(_mm512_add_pd(A, D), E))
+          , b(_mm512_add_pd(_mm512_add_pd(B, C), _F))
+          , value(_mm512_fmadd_pd(three, s,
+                  _mm512_fmadd_pd(_mm512_fnmadd_pd(two, q, p), a,
+                  _mm512_mul_pd(_mm512_fnmadd_pd(two, p, q), b))))
+          ;
+        acc = _mm512_fmadd_pd(value,
+          i == 0 && r.diagonal ? _mm512_mask_mul_pd(inverse, 1, inverse, half)
+                               : inverse,
+          acc);
+      }
+      return reduceAddAvx512(acc);
+    }
+
+    __attribute__((target("avx512f")))
+    inline double sameRowAvx512(Row<double> const& r) {
+      const long long No(r.No), NoNo(No*No);
+      const __m512i
+          sNo(_mm512_set_epi64(7*No, 6*No, 5*No, 4*No, 3*No, 2*No, No, 0))
+        , sNoNo(_mm512_set_epi64( 7*NoNo, 6*NoNo, 5*NoNo, 4*NoNo
+                                , 3*NoNo, 2*NoNo, NoNo, 0));
+      const __m512d
+          three(_mm512_set1_pd(3.0))
+        , one(_mm512_set1_pd(1.0)), half(_mm512_set1_pd(0.5))
+        , epsjk(_mm512_set1_pd(r.epsjk));
+      const __m512d zero(_mm512_setzero_pd());
+      __m512d acc(zero);
+      for (size_t i(0); i < r.n; i += 8) {
+        const __mmask8 m(r.n - i < 8 ? (1u << (r.n - i)) - 1 : 0xff);
+        const __m512d
+            U(_mm512_maskz_loadu_pd(m, r.U + i))
+          , V(_mm512_mask_i64gather_pd(zero, m, sNoNo, r.X + NoNo*i, 8))
+          , W(_mm512_mask_i64gather_pd(zero, m, sNo, r.Y + No*i, 8))
+          , A(_mm512_maskz_loadu_pd(m, r.A + i))
+          , B(_mm512_mask_i64gather_pd(zero, m, sNoNo, r.D + NoNo*i, 8))
+          , C(_mm512_mask_i64gather_pd(zero, m, sNo, r.E + No*i, 8))
+          , inverse(_mm512_maskz_div_pd(m, one,
+              _mm512_sub_pd(epsjk, _mm512_maskz_loadu_pd(m, r.epsi + i))))
+          , s(_mm512_fmadd_pd(A, U,
+              _mm512_fmadd_pd(B, V,
+              _mm512_mul_pd(C, W))))
+          , value(_mm512_fmsub_pd(three, s,
+                  _mm512_mul_pd(_mm512_add_pd(_mm512_add_pd(A, B), C),
+                                _mm512_add_pd(_mm512_add_pd(U, V), W))))
+          ;
+        acc = _mm512_fmadd_pd(value,
+          i == 0 && r.diagonal ? _mm512_mask_mul_pd(inverse, 1, inverse, half)
+                               : inverse,
+          acc);
+      }
+      return reduceAddAvx512(acc);
+    }
+
+    // flatten inlines the row kernel into the loops of sumRows
+    __attribute__((target("avx2,fma"), flatten))
+    inline double distinctAvx2
+      ( const double epsabc
+      , std::vector<double> const& epsi
+      , std::vector<double> const& Tijk_
+      , std::vector<double> const& Zijk_
+      ) {
+      return sumRows<double, distinctRowAvx2>(epsabc, epsi, Tijk_, Zijk_);
+    }
+
+    // flatten inlines the row kernel into the loops of sumRows
+    __attribute__((target("avx512f"), flatten))
+    inline double distinctAvx512
+      ( const double epsabc
+      , std::vector<double> const& epsi
+      , std::vector<double> const& Tijk_
+      , std::vector<double> const& Zijk_
+      ) {
+      return sumRows<double, distinctRowAvx512>(epsabc, epsi, Tijk_, Zijk_);
+    }
+
+    // flatten inlines the row kernel into the loops of sumRows
+    __attribute__((target("avx2,fma"), flatten))
+    inline double sameAvx2
+      ( const double epsabc
+      , std::vector<double> const& epsi
+      , std::vector<double> const& Tijk_
+      , std::vector<double> const& Zijk_
+      ) {
+      return sumRows<double, sameRowAvx2>(epsabc, epsi, Tijk_, Zijk_);
+    }
+
+    // flatten inlines the row kernel into the loops of sumRows
+    __attribute__((target("avx512f"), flatten))
+    inline double sameAvx512
+      ( const double epsabc
+      , std::vector<double> const& epsi
+      , std::vector<double> const& Tijk_
+      , std::vector<double> const& Zijk_
+      ) {
+      return sumRows<double, sameRowAvx512>(epsabc, epsi, Tijk_, Zijk_);
+    }
+
+    template <>
+    inline double distinct<double>
+      ( const double epsabc
+      , std::vector<double> const& epsi
+      , std::vector<double> const& Tijk_
+      , std::vector<double> const& Zijk_
+      ) {
+      switch (isa()) {
+        case Isa::Avx512: return distinctAvx512(epsabc, epsi, Tijk_, Zijk_);
+        case Isa::Avx2: return distinctAvx2(epsabc, epsi, Tijk_, Zijk_);
+        default:
+          return sumRows<double, distinctRowScalar<double>>
+            (epsabc, epsi, Tijk_, Zijk_);
+      }
+    }
+
+    template <>
+    inline double same<double>
+      ( const double epsabc
+      , std::vector<double> const& epsi
+      , std::vector<double> const& Tijk_
+      , std::vector<double> const& Zijk_
+      ) {
+      switch (isa()) {
+        case Isa::Avx512: return sameAvx512(epsabc, epsi, Tijk_, Zijk_);
+        case Isa::Avx2: return sameAvx2(epsabc, epsi, Tijk_, Zijk_);
+        default:
+          return sumRows<double, sameRowScalar<double>>
+            (epsabc, epsi, Tijk_, Zijk_);
+      }
+    }
+#endif
+
+  }
+
   template <typename F=double>
   double getEnergyDistinct
     ( const F epsabc
@@ -27,61 +489,7 @@ namespace atrip {
     , std::vector<F> const& Tijk_
     , std::vector<F> const& Zijk_
     ) {
-    constexpr size_t blockSize=16;
-    F energy(0.);
-    const size_t No = epsi.size();
-    for (size_t kk=0; kk<No; kk+=blockSize){
-      const size_t kend( std::min(No, kk+blockSize) );
-      for (size_t jj(kk); jj<No; jj+=blockSize){
-        const size_t jend( std::min( No, jj+blockSize) );
-        for (size_t ii(jj); ii<No; ii+=blockSize){
-          const size_t iend( std::min( No, ii+blockSize) );
-          for (size_t k(kk); k < kend; k++){
-            const F ek(epsi[k]);
-            const size_t jstart = jj > k ? jj : k;
-            for (size_t j(jstart); j < jend; j++){
-              F const ej(epsi[j]);
-              F const facjk = j == k ? F(0.5) : F(1.0);
-              size_t istart = ii > j ? ii : j;
-              for (size_t i(istart); i < iend; i++){
-                const F
-                    ei(epsi[i])
-                  , facij = i == j ? F(0.5) : F(1.0)
-                  , denominator(epsabc - ei - ej - ek)
-                  , U(Zijk_[i + No*j + No*No*k])
-                  , V(Zijk_[i + No*k + No*No*j])
-                  , W(Zijk_[j + No*i + No*No*k])
-                  , X(Zijk_[j + No*k + No*No*i])
-                  , Y(Zijk_[k + No*i + No*No*j])
-                  , Z(Zijk_[k + No*j + No*No*i])
-                  , A(maybeConjugate<F>(Tijk_[i + No*j + No*No*k]))
-                  , B(maybeConjugate<F>(Tijk_[i + No*k + No*No*j]))
-                  , C(maybeConjugate<F>(Tijk_[j + No*i + No*No*k]))
-                  , D(maybeConjugate<F>(Tijk_[j + No*k + No*No*i]))
-                  , E(maybeConjugate<F>(Tijk_[k + No*i + No*No*j]))
-                  , _F(maybeConjugate<F>(Tijk_[k + No*j + No*No*i]))
-                  , value
-                    = 3.0 * ( A * U
-                              + B * V
-                              + C * W
-                              + D * X
-                              + E * Y
-                              + _F * Z )
-                   + ( ( U + X + Y )
-                     - 2.0 * ( V + W + Z )
-                     ) * ( A + D + E )
-                   + ( ( V + W + Z )
-                     - 2.0 * ( U + X + Y )
-                     ) * ( B + C + _F )
-                  ;
-                energy += 2.0 * value / denominator * facjk * facij;
-              } // i
-            } // j
-          } // k
-        } // ii
-      } // jj
-    } // kk
-    return std::real(energy);
+    return std::real(energy::distinct<F>(epsabc, epsi, Tijk_, Zijk_));
   }
 
 
@@ -92,48 +500,7 @@ namespace atrip {
     , std::vector<F> const& Tijk_
     , std::vector<F> const& Zijk_
     ) {
-    constexpr size_t blockSize = 16;
-    const size_t No = epsi.size();
-    F energy = F(0.);
-    for (size_t kk=0; kk<No; kk+=blockSize){
-      const size_t kend( std::min( kk+blockSize, No) );
-      for (size_t jj(kk); jj<No; jj+=blockSize){
-        const size_t jend( std::min( jj+blockSize, No) );
-        for (size_t ii(jj); ii<No; ii+=blockSize){
-          const size_t iend( std::min( ii+blockSize, No) );
-          for (size_t k(kk); k < kend; k++){
-            const F ek(epsi[k]);
-            const size_t jstart = jj > k ? jj : k;
-            for(size_t j(jstart); j < jend; j++){
-              const F facjk( j == k ? F(0.5) : F(1.0));
-              const F ej(epsi[j]);
-              const size_t istart = ii > j ? ii : j;
-              for(size_t i(istart); i < iend; i++){
-                const F
-                  ei(epsi[i])
-                , facij ( i==j ? F(0.5) : F(1.0))
-                , denominator(epsabc - ei - ej - ek)
-                , U(Zijk_[i + No*j + No*No*k])
-                , V(Zijk_[j + No*k + No*No*i])
-                , W(Zijk_[k + No*i + No*No*j])
-                , A(maybeConjugate<F>(Tijk_[i + No*j + No*No*k]))
-                , B(maybeConjugate<F>(Tijk_[j + No*k + No*No*i]))
-                , C(maybeConjugate<F>(Tijk_[k + No*i + No*No*j]))
-                , value
-                  = F(3.0) * ( A * U
-                             + B * V
-                             + C * W
-                             )
-                  - ( A + B + C ) * ( U + V + W )
-                ;
-                energy += F(2.0) * value / denominator * facjk * facij;
-              } // i
-            } // j
-          } // k
-        } // ii
-      } // jj
-    } // kk
-    return std::real(energy);
+    return std::real(energy::same<F>(epsabc, epsi, Tijk_, Zijk_));
   }
 
   template <typename F=double>
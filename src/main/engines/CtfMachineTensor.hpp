@@ -17,6 +17,7 @@
 #define CTF_MACHINE_TENSOR_DEFINED
 
 #include <SharedPointer.hpp>
+#include <MemoryTracker.hpp>
 
 #include <ctf.hpp>
 #include <string>
@@ -52,13 +53,16 @@ namespace cc4s {
         CTF::get_universe(), name.c_str()
       )
     {
+      MemoryTracker::allocate(this, name, sizeof(F) * tensor.size);
     }
 
     // copy constructor from CTF tensor
     CtfMachineTensor(const T &t, const ProtectedToken &): tensor(t) {
+      MemoryTracker::allocate(this, t.get_name(), sizeof(F) * tensor.size);
     }
 
     ~CtfMachineTensor() {
+      MemoryTracker::free(this);
     }
 
     // this[bIndices] = alpha * A[aIndices] + beta*this[bIndices]
@@ -190,6 +194,19 @@ namespace cc4s {
       tensor.write_dense_to_file(file, offset);
     }
 
+    // read the elements stored on this rank with their global indices
+    void readLocal(std::vector<size_t> &indices, std::vector<F> &values) {
+      int64_t elementsCount;
+      int64_t *indexData;
+      F *valueData;
+      tensor.read_local(&elementsCount, &indexData, &valueData);
+      indices.assign(indexData, indexData + elementsCount);
+      values.assign(valueData, valueData + elementsCount);
+      // allocated by CTF
+      free(indexData);
+      free(valueData);
+    }
+
     // write tensor elements to buffer
     void write(
       const size_t elementsCount, const size_t *indexData, const F *valueData
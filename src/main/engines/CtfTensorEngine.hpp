@@ -19,6 +19,7 @@
 #include <engines/CtfMachineTensor.hpp>
 #include <tcc/Costs.hpp>
 #include <MathFunctions.hpp>
+#include <Cc4s.hpp>
 
 // TODO: create object of this class for runtime arguments of tensor engine
 // such as MPI communicators
@@ -35,9 +36,17 @@ namespace cc4s {
      * \brief Returns -1,0, or +1 depending on whether the given costs
      * satisfy l<r, l=r, or l>r, respectively.
      * The comparison depends on the tensor engine's estimate.
+     * Costs whose maximum storage fits into the memory of all ranks
+     * are always less than costs exceeding it.
      **/
     template <typename F>
     static int compareCosts(const Costs &l, const Costs &r) {
+      const Natural<128> memory(
+        Natural<128>(Cc4s::getMemoryPerRank()) * Cc4s::getProcessesCount()
+      );
+      const bool lFits(l.maxStorageCount * sizeof(F) <= memory);
+      const bool rFits(r.maxStorageCount * sizeof(F) <= memory);
+      if (lFits != rFits) return lFits ? -1 : +1;
       Natural<128> lTotal(
         1000 * l.maxStorageCount +
         10 * l.accessCount +
@@ -45,8 +54,8 @@ namespace cc4s {
         l.additionsCount
       );
       Natural<128> rTotal(
-        1000 * l.maxStorageCount +
-        10 * l.accessCount +
+        1000 * r.maxStorageCount +
+        10 * r.accessCount +
         sizeof(F) / sizeof(real(F(0))) * r.multiplicationsCount +
         r.additionsCount
       );
@@ -141,6 +141,11 @@ namespace cc4s {
     void readToFile(MPI_File &file, const size_t offset = 0) {
     }
 
+    void readLocal(std::vector<size_t> &indices, std::vector<F> &values) {
+      indices.clear();
+      values.clear();
+    }
+
     // write tensor elements from buffer
     void write(
       const size_t elementsCount, const size_t *indexData, const F *valueData
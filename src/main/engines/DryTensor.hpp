@@ -38,7 +38,8 @@ namespace cc4s {
         extendingResources.push_back(
           ExtendingResource(maxTotalSize, location)
         );
-        LOG_LOCATION(location) << "extending memory size to " << size << std::endl;
+        LOG_CATEGORY_LOCATION("memory", 1, location)
+          << "extending memory size to " << size << std::endl;
       } else {
 /*
         LOG_LOCATION(location) << "memory size " << size << std::endl;
@@ -120,6 +120,29 @@ extern "C" {
     const int *lwork,
     const int *info
   );
+  void dsyev_(
+    const char *jobz,
+    const char *uplo,
+    const int *n,
+    cc4s::Real<64> *a,
+    const int *lda,
+    cc4s::Real<64> *w,
+    cc4s::Real<64> *work,
+    const int *lwork,
+    int *info
+  );
+  void zheev_(
+    const char *jobz,
+    const char *uplo,
+    const int *n,
+    cc4s::Complex<64> *a,
+    const int *lda,
+    cc4s::Real<64> *w,
+    cc4s::Complex<64> *work,
+    const int *lwork,
+    cc4s::Real<64> *rwork,
+    int *info
+  );
   void dgetrf_(
     const int *m,
     const int *n,
@@ -0,0 +1,134 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LAPACK_HERMITIAN_EIGEN_SYSTEM_DEFINED
+#define LAPACK_HERMITIAN_EIGEN_SYSTEM_DEFINED
+
+#include <extern/Lapack.hpp>
+#include <Real.hpp>
+#include <Complex.hpp>
+#include <lapack/LapackMatrix.hpp>
+#include <Exception.hpp>
+
+#include <vector>
+#include <sstream>
+#include <algorithm>
+
+namespace cc4s {
+  // base template
+  template <typename F=Real<>>
+  class LapackHermitianEigenSystem;
+
+  /**
+   * \brief Diagonalizes a real symmetric matrix given by its upper
+   * triangle. The eigenvalues are in ascending order and the respective
+   * orthonormal eigenvectors are the columns of the eigenvector matrix.
+   **/
+  template <>
+  class LapackHermitianEigenSystem<Real<64>> {
+  public:
+    LapackHermitianEigenSystem(
+      const LapackMatrix<Real<64>> &A
+    ): U(A), lambdas(A.getRows()) {
+      if (A.getRows() != A.getColumns()) {
+        THROW("EigenSystem requires a square matrix");
+      }
+      int rows(A.getRows());
+      Real<64> optimalWork;
+      int workCount(-1);
+      int info;
+      dsyev_(
+        "V", "U", &rows, U.getValues(), &rows, lambdas.data(),
+        &optimalWork, &workCount, &info
+      );
+      workCount = std::max(1, static_cast<int>(optimalWork+0.5));
+      std::vector<Real<64>> work(workCount);
+      dsyev_(
+        "V", "U", &rows, U.getValues(), &rows, lambdas.data(),
+        work.data(), &workCount, &info
+      );
+      if (info < 0) {
+        std::stringstream stream;
+        stream << "Argument " << -info << " of DSYEV is illegal";
+        THROW(stream.str());
+      }
+      if (info > 0) THROW("DSYEV failed to converge");
+    }
+
+    const std::vector<Real<64>> &getEigenValues() const {
+      return lambdas;
+    }
+
+    const LapackMatrix<Real<64>> &getEigenVectors() const {
+      return U;
+    }
+
+  protected:
+    LapackMatrix<Real<64>> U;
+    std::vector<Real<64>> lambdas;
+  };
+
+  /**
+   * \brief Diagonalizes a complex hermitian matrix given by its upper
+   * triangle. The eigenvalues are in ascending order and the respective
+   * orthonormal eigenvectors are the columns of the eigenvector matrix.
+   **/
+  template <>
+  class LapackHermitianEigenSystem<Complex<64>> {
+  public:
+    LapackHermitianEigenSystem(
+      const LapackMatrix<Complex<64>> &A
+    ): U(A), lambdas(A.getRows()) {
+      if (A.getRows() != A.getColumns()) {
+        THROW("EigenSystem requires a square matrix");
+      }
+      int rows(A.getRows());
+      std::vector<Real<64>> realWork(std::max(1, 3*rows-2));
+      Complex<64> optimalWork;
+      int workCount(-1);
+      int info;
+      zheev_(
+        "V", "U", &rows, U.getValues(), &rows, lambdas.data(),
+        &optimalWork, &workCount, realWork.data(), &info
+      );
+      workCount = std::max(1, static_cast<int>(real(optimalWork)+0.5));
+      std::vector<Complex<64>> work(workCount);
+      zheev_(
+        "V", "U", &rows, U.getValues(), &rows, lambdas.data(),
+        work.data(), &workCount, realWork.data(), &info
+      );
+      if (info < 0) {
+        std::stringstream stream;
+        stream << "Argument " << -info << " of ZHEEV is illegal";
+        THROW(stream.str());
+      }
+      if (info > 0) THROW("ZHEEV failed to converge");
+    }
+
+    const std::vector<Real<64>> &getEigenValues() const {
+      return lambdas;
+    }
+
+    const LapackMatrix<Complex<64>> &getEigenVectors() const {
+      return U;
+    }
+
+  protected:
+    LapackMatrix<Complex<64>> U;
+    std::vector<Real<64>> lambdas;
+  };
+}
+
+#endif
@@ -16,14 +16,16 @@
 #ifndef LAPACK_MATRIX_DEFINED
 #define LAPACK_MATRIX_DEFINED
 
+#include <Real.hpp>
 #include <Complex.hpp>
+#include <Exception.hpp>
 
 #include <vector>
 #include <sstream>
 #include <ctf.hpp>
 
 namespace cc4s {
-  template <typename F=real>
+  template <typename F=Real<>>
   class LapackMatrix {
   public:
     /**
@@ -118,7 +120,7 @@ namespace cc4s {
           stream << join << ctfA.lens[d];
           join = "x";
         }
-        throw new EXCEPTION(stream.str());
+        THROW(stream.str());
       }
       int64_t size(values.size());
       int64_t localSize(ctfA.wrld->rank == 0 ? size : 0);
@@ -141,7 +143,7 @@ namespace cc4s {
 
   // TODO: use blas (D|Z)GEMM for matrix multiplication
   // TODO: support move semantics
-  template <typename F=real>
+  template <typename F=Real<>>
   LapackMatrix<F> operator *(
     const LapackMatrix<F> &A, const LapackMatrix<F> &B
   ) {
@@ -150,7 +152,7 @@ namespace cc4s {
       stream << "Matrix shapes not compatible for multiplication: ("
         << A.getRows() << "x" << A.getColumns() << ") . ("
         << B.getRows() << "x" << B.getColumns() << ")";
-      throw new EXCEPTION(stream.str());
+      THROW(stream.str());
     }
     LapackMatrix<F> C(A.getRows(), B.getColumns());
     for (int i(0); i < A.getRows(); ++i) {
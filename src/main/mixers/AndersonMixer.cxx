@@ -0,0 +1,281 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mixers/AndersonMixer.hpp>
+#include <algorithms/Algorithm.hpp>
+#include <extern/Lapack.hpp>
+#include <SharedPointer.hpp>
+#include <Log.hpp>
+#include <Node.hpp>
+
+using namespace cc4s;
+
+MIXER_REGISTRAR_DEFINITION(AndersonMixer)
+
+template <typename F, typename TE>
+AndersonMixer<F,TE>::AndersonMixer(
+  const Ptr<MapNode> &arguments
+):
+  Mixer<F,TE>(arguments), next(nullptr),
+  lastAmplitudes(nullptr), lastResiduum(nullptr),
+  lastResiduumNormSquare(0), residuumNorm(0)
+{
+  maxHistory = arguments->getValue<size_t>("maxHistory", 8);
+  ratio = arguments->getValue<Real<>>("ratio", 1.0);
+  maxCondition = arguments->getValue<Real<>>("maxCondition", 1e12);
+  restartRatio = arguments->getValue<Real<>>("restartRatio", 4.0);
+  ASSERT_LOCATION(
+    maxHistory > 0, "Expecting maxHistory of at least 1",
+    arguments->get("maxHistory")->sourceLocation
+  );
+  LOG() << "maxHistory=" << maxHistory << ", ratio=" << ratio << std::endl;
+}
+
+template <typename F, typename TE>
+AndersonMixer<F,TE>::~AndersonMixer() {
+}
+
+template <typename F, typename TE>
+std::string AndersonMixer<F,TE>::describeOptions() {
+  std::stringstream stream;
+  stream << "maxHistory: " << maxHistory << ", ratio: " << ratio;
+  return stream.str();
+}
+
+template <typename F, typename TE>
+void AndersonMixer<F,TE>::append(
+  const Ptr<TensorSet<F,TE>> &A,
+  const Ptr<TensorSet<F,TE>> &R
+) {
+  // overlaps of the residuum with itself, the last residuum and the
+  // residua differences, computed in one batch
+  std::vector<Ptr<TensorSet<F,TE>>> kets(1, R);
+  if (lastResiduum) kets.push_back(lastResiduum);
+  kets.insert(kets.end(), residuaDifferences.begin(), residuaDifferences.end());
+  auto overlaps(R->dot(kets));
+  Real<> residuumNormSquare(real(overlaps[0]));
+
+  if (lastResiduum) {
+    Real<> reduction(
+      lastResiduumNormSquare > 0 ?
+        sqrt(residuumNormSquare / lastResiduumNormSquare) : 0.0
+    );
+    LOG() << "residuum reduction=" << reduction << std::endl;
+    if (reduction > restartRatio) {
+      LOG() << "restarting history after residuum increase" << std::endl;
+      while (residuaDifferences.size() > 0) dropOldest();
+    } else {
+      // the overlaps with the new difference follow from the overlaps
+      // of the previous differences with the last residuum
+      std::deque<Real<>> newOverlaps;
+      for (size_t i(0); i < residuaDifferences.size(); ++i) {
+        Real<> overlap(real(overlaps[2+i]) - residuumOverlaps[i]);
+        differencesOverlaps[i].push_back(overlap);
+        newOverlaps.push_back(overlap);
+        residuumOverlaps[i] = real(overlaps[2+i]);
+      }
+      newOverlaps.push_back(
+        residuumNormSquare - 2*real(overlaps[1]) + lastResiduumNormSquare
+      );
+      differencesOverlaps.push_back(newOverlaps);
+      residuumOverlaps.push_back(residuumNormSquare - real(overlaps[1]));
+      residuaDifferences.push_back(
+        TensorSet<F,TE>::linearCombination({F(1), F(-1)}, {R, lastResiduum})
+      );
+      amplitudesDifferences.push_back(
+        TensorSet<F,TE>::linearCombination(
+          {F(1), F(-1)}, {A, lastAmplitudes}
+        )
+      );
+      if (residuaDifferences.size() > maxHistory) dropOldest();
+    }
+  }
+  lastAmplitudes = A;
+  lastResiduum = R;
+  lastResiduumNormSquare = residuumNormSquare;
+
+  // build the next amplitudes in a single pass
+  auto gamma(getCoefficients());
+  std::vector<F> coefficients(1, F(1));
+  std::vector<Ptr<TensorSet<F,TE>>> terms(1, A);
+  if (ratio != 1.0) {
+    coefficients.push_back(F(ratio-1));
+    terms.push_back(R);
+  }
+  Real<> extrapolatedNormSquare(residuumNormSquare);
+  for (size_t i(0); i < gamma.size(); ++i) {
+    LOG() << "gamma^(-" << (gamma.size()-i) << ")=" << gamma[i] << std::endl;
+    coefficients.push_back(F(-gamma[i]));
+    terms.push_back(amplitudesDifferences[i]);
+    if (ratio != 1.0) {
+      coefficients.push_back(F((1-ratio)*gamma[i]));
+      terms.push_back(residuaDifferences[i]);
+    }
+    extrapolatedNormSquare -= 2*gamma[i]*residuumOverlaps[i];
+    for (size_t j(0); j < gamma.size(); ++j) {
+      extrapolatedNormSquare += gamma[i]*gamma[j]*differencesOverlaps[i][j];
+    }
+  }
+  next = TensorSet<F,TE>::linearCombination(coefficients, terms);
+  residuumNorm = sqrt(std::max(extrapolatedNormSquare, 0.0));
+  LOG() << "history=" << gamma.size() << std::endl;
+}
+
+template <typename F, typename TE>
+Ptr<MapNode> AndersonMixer<F,TE>::writeState(const std::string &path) {
+  if (!lastResiduum) return nullptr;
+  auto state(New<MapNode>(SOURCE_LOCATION));
+  state->setValue<std::string>("last", path + ".last.yaml");
+  state->setValue<std::string>("lastResiduum", path + ".lastResiduum.yaml");
+  this->writeTensorSet(state->getValue<std::string>("last"), lastAmplitudes);
+  this->writeTensorSet(
+    state->getValue<std::string>("lastResiduum"), lastResiduum
+  );
+  state->setValue<Real<>>("lastResiduumNormSquare", lastResiduumNormSquare);
+  auto n(residuaDifferences.size());
+  if (n == 0) return state;
+  auto history(New<MapNode>(SOURCE_LOCATION));
+  std::vector<Real<>> overlaps;
+  for (size_t i(0); i < n; ++i) {
+    auto index(std::to_string(i));
+    auto entry(New<MapNode>(SOURCE_LOCATION));
+    entry->setValue<std::string>(
+      "amplitudes", path + ".amplitudesDifference" + index + ".yaml"
+    );
+    entry->setValue<std::string>(
+      "residuum", path + ".residuumDifference" + index + ".yaml"
+    );
+    this->writeTensorSet(
+      entry->getValue<std::string>("amplitudes"), amplitudesDifferences[i]
+    );
+    this->writeTensorSet(
+      entry->getValue<std::string>("residuum"), residuaDifferences[i]
+    );
+    history->get(i) = entry;
+    for (size_t j(0); j < n; ++j) overlaps.push_back(differencesOverlaps[i][j]);
+  }
+  state->get("history") = history;
+  state->get("differencesOverlaps") =
+    New<ArrayNode<Real<>>>(overlaps, SOURCE_LOCATION);
+  state->get("residuumOverlaps") = New<ArrayNode<Real<>>>(
+    std::vector<Real<>>(residuumOverlaps.begin(), residuumOverlaps.end()),
+    SOURCE_LOCATION
+  );
+  return state;
+}
+
+template <typename F, typename TE>
+void AndersonMixer<F,TE>::readState(const Ptr<MapNode> &state) {
+  lastAmplitudes = this->readTensorSet(state->getValue<std::string>("last"));
+  lastResiduum = this->readTensorSet(
+    state->getValue<std::string>("lastResiduum")
+  );
+  lastResiduumNormSquare = state->getValue<Real<>>("lastResiduumNormSquare");
+  while (residuaDifferences.size() > 0) dropOldest();
+  if (!state->isGiven("history")) return;
+  auto history(state->getMap("history"));
+  auto overlaps(state->getArray<Real<>>("differencesOverlaps"));
+  auto residuumOverlapsNode(state->getArray<Real<>>("residuumOverlaps"));
+  size_t n(history->getSize());
+  ASSERT_LOCATION(
+    overlaps->getSize() == n*n && residuumOverlapsNode->getSize() == n,
+    "Expecting overlaps for each difference", history->sourceLocation
+  );
+  for (size_t i(0); i < n; ++i) {
+    auto entry(history->getMap(std::to_string(i)));
+    amplitudesDifferences.push_back(
+      this->readTensorSet(entry->getValue<std::string>("amplitudes"))
+    );
+    residuaDifferences.push_back(
+      this->readTensorSet(entry->getValue<std::string>("residuum"))
+    );
+    differencesOverlaps.push_back(std::deque<Real<>>());
+    for (size_t j(0); j < n; ++j) {
+      differencesOverlaps[i].push_back((*overlaps)[i*n+j]);
+    }
+    residuumOverlaps.push_back((*residuumOverlapsNode)[i]);
+  }
+  // the given maxHistory takes precedence over the one of the state
+  while (residuaDifferences.size() > maxHistory) dropOldest();
+}
+
+template <typename F, typename TE>
+void AndersonMixer<F,TE>::dropOldest() {
+  amplitudesDifferences.pop_front();
+  residuaDifferences.pop_front();
+  differencesOverlaps.pop_front();
+  for (auto &row: differencesOverlaps) row.pop_front();
+  residuumOverlaps.pop_front();
+}
+
+template <typename F, typename TE>
+std::vector<Real<>> AndersonMixer<F,TE>::getCoefficients() {
+  while (residuaDifferences.size() > 0 && !Cc4s::dryRun) {
+    int n(residuaDifferences.size());
+    // diagonalize the overlap matrix of the differences
+    std::vector<Real<>> eigenVectors(n*n);
+    for (int i(0); i < n; ++i) {
+      for (int j(0); j < n; ++j) {
+        eigenVectors[i+n*j] = differencesOverlaps[i][j];
+      }
+    }
+    std::vector<Real<>> eigenValues(n);
+    int workSize(3*n);
+    std::vector<Real<>> work(workSize);
+    int info;
+    dsyev_(
+      "V", "U", &n, eigenVectors.data(), &n, eigenValues.data(),
+      work.data(), &workSize, &info
+    );
+    if (info != 0) THROW("Diagonalization failed");
+    // eigenvalues are in ascending order
+    if (
+      eigenValues[0] > 0 && eigenValues[n-1] <= maxCondition * eigenValues[0]
+    ) {
+      std::vector<Real<>> gamma(n, 0.0);
+      for (int k(0); k < n; ++k) {
+        Real<> projection(0);
+        for (int i(0); i < n; ++i) {
+          projection += eigenVectors[i+n*k] * residuumOverlaps[i];
+        }
+        for (int i(0); i < n; ++i) {
+          gamma[i] += eigenVectors[i+n*k] * projection / eigenValues[k];
+        }
+      }
+      return gamma;
+    }
+    LOG() << "dropping oldest difference, overlap eigenvalues from "
+      << eigenValues[0] << " to " << eigenValues[n-1] << std::endl;
+    dropOldest();
+  }
+  return std::vector<Real<>>(residuaDifferences.size(), 0.0);
+}
+
+template <typename F, typename TE>
+Ptr<TensorSet<F,TE>> AndersonMixer<F,TE>::get() {
+  return next;
+}
+
+template <typename F, typename TE>
+Real<> AndersonMixer<F,TE>::getResiduumNorm() {
+  return residuumNorm;
+}
+
+// instantiate
+template class cc4s::AndersonMixer<Real<64>, DefaultDryTensorEngine>;
+template class cc4s::AndersonMixer<Complex<64>, DefaultDryTensorEngine>;
+template class cc4s::AndersonMixer<Real<64>, DefaultTensorEngine>;
+template class cc4s::AndersonMixer<Complex<64>, DefaultTensorEngine>;
+
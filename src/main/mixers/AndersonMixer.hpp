@@ -0,0 +1,98 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDERSON_MIXER_DEFINED
+#define ANDERSON_MIXER_DEFINED
+
+#include <mixers/Mixer.hpp>
+
+#include <SharedPointer.hpp>
+
+#include <deque>
+#include <vector>
+
+namespace cc4s {
+  /**
+   * \brief Restarted Anderson mixer with adaptive history.
+   * Given the amplitudes \f$A_k\f$ and residua \f$R_k\f$ of the
+   * iterations, the coefficients \f$\gamma\f$ minimize the norm of the
+   * extrapolated residuum \f$R_k - \sum_i\gamma_i\Delta R_i\f$, where
+   * \f$\Delta R_i\f$ and \f$\Delta A_i\f$ are the differences of subsequent
+   * residua and amplitudes, respectively. The next amplitudes are
+   * \f$A_k - \sum_i\gamma_i\Delta A_i - (1-\beta)(R_k-\sum_i\gamma_i\Delta R_i)\f$
+   * with the mixing ratio \f$\beta\f$.
+   * Oldest differences are dropped while their overlap matrix is
+   * ill-conditioned and the history is restarted if the residuum grows
+   * too much.
+   **/
+  template <typename F, typename TE>
+  class AndersonMixer: public Mixer<F,TE> {
+  public:
+    MIXER_REGISTRAR_DECLARATION(AndersonMixer)
+    AndersonMixer(const Ptr<MapNode> &arguments);
+    virtual ~AndersonMixer();
+
+    std::string describeOptions() override;
+
+    void append(
+      const Ptr<TensorSet<F,TE>> &A, const Ptr<TensorSet<F,TE>> &R
+    ) override ;
+    Ptr<TensorSet<F,TE>> get() override;
+    Real<> getResiduumNorm() override;
+    Ptr<MapNode> writeState(const std::string &path) override;
+    void readState(const Ptr<MapNode> &state) override;
+
+    Ptr<TensorSet<F,TE>> next;
+    Ptr<TensorSet<F,TE>> lastAmplitudes;
+    Ptr<TensorSet<F,TE>> lastResiduum;
+
+    /**
+     * \brief Differences of subsequent amplitudes and residua,
+     * oldest first.
+     **/
+    std::deque<Ptr<TensorSet<F,TE>>> amplitudesDifferences;
+    std::deque<Ptr<TensorSet<F,TE>>> residuaDifferences;
+    /**
+     * \brief Real part of the overlap matrix of the residua differences.
+     **/
+    std::deque<std::deque<Real<>>> differencesOverlaps;
+    /**
+     * \brief Real part of the overlaps of the residua differences with
+     * the last residuum.
+     **/
+    std::deque<Real<>> residuumOverlaps;
+
+    size_t maxHistory;
+    Real<> ratio;
+    Real<> maxCondition;
+    Real<> restartRatio;
+    Real<> lastResiduumNormSquare;
+    Real<> residuumNorm;
+
+    /**
+     * \brief Drops the oldest differences from the history.
+     **/
+    void dropOldest();
+    /**
+     * \brief Drops the oldest differences until their overlap matrix
+     * has a condition number of at most maxCondition, and returns the
+     * coefficients minimizing the norm of the extrapolated residuum.
+     **/
+    std::vector<Real<>> getCoefficients();
+  };
+}
+
+#endif
+
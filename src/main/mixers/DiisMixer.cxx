@@ -19,6 +19,12 @@
 #include <SharedPointer.hpp>
 #include <Log.hpp>
 #include <Node.hpp>
+#include <ByteShuffleCodec.hpp>
+
+#include <fstream>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace cc4s;
 
@@ -28,30 +34,319 @@ template <typename F, typename TE>
 DiisMixer<F,TE>::DiisMixer(
   const Ptr<MapNode> &arguments
 ):
-  Mixer<F,TE>(arguments), next(nullptr), nextResiduum(nullptr)
+  Mixer<F,TE>(arguments), next(nullptr), nextResiduum(nullptr),
+  removeHistoryDirectory(false)
 {
-  N = arguments->getValue<size_t>("maxResidua", 4);
+  setMaxResidua(arguments->getValue<size_t>("maxResidua", 4));
+  historyStorage = arguments->getValue<std::string>("historyStorage", "auto");
+  ASSERT_LOCATION(
+    historyStorage == "auto" || historyStorage == "memory" ||
+      historyStorage == "disk" || historyStorage == "compressed",
+    "Expecting historyStorage auto, memory, disk or compressed",
+    arguments->get("historyStorage")->sourceLocation
+  );
+  historyDirectory =
+    arguments->getValue<std::string>("historyDirectory", "cc4s.diis");
+  errorBound = arguments->getValue<Real<>>("errorBound", 0.0);
   LOG() << "maxResidua=" << N << std::endl;
+}
 
-  amplitudes.resize(N);
-  residua.resize(N);
+template <typename F, typename TE>
+void DiisMixer<F,TE>::setMaxResidua(const size_t maxResidua) {
+  N = maxResidua;
+  amplitudes.assign(N, nullptr);
+  residua.assign(N, nullptr);
+  amplitudesFiles.assign(N, "");
+  residuaFiles.assign(N, "");
+  prefetched.clear();
   nextIndex = 0;
   count = 0;
   size_t M(N+1);
   // set up overlap matrix
-  B.resize(M*M,0);
+  B.assign(M*M,0);
   for ( size_t i(1); i<M; i++){ B[i] = -1;}
   for ( size_t i(M); i<M*M; i=i+M){ B[i] = -1;}
 }
 
+template <typename F, typename TE>
+void DiisMixer<F,TE>::fitMaxResiduaIntoMemory(
+  const Ptr<TensorSet<F,TE>> &A
+) {
+  Natural<128> elementsCount(0);
+  for (auto key: A->getKeys()) {
+    elementsCount += A->get(key)->inspect()->getElementsCount();
+  }
+  // each entry holds the amplitudes and the residuum
+  Natural<128> entrySize(2 * elementsCount * sizeof(F));
+  Natural<128> memory(
+    Natural<128>(Cc4s::getMemoryShare(Cc4s::HISTORY_MEMORY)) *
+      Cc4s::getProcessesCount()
+  );
+  size_t maxResidua(std::max(Natural<128>(2), memory / entrySize));
+  if (maxResidua < N) {
+    WARNING() << "maxResidua reduced from " << N << " to " << maxResidua
+      << " to fit into the memory per rank" << std::endl;
+    setMaxResidua(maxResidua);
+  }
+}
+
+template <typename F, typename TE>
+void DiisMixer<F,TE>::chooseHistoryStorage(const Ptr<TensorSet<F,TE>> &A) {
+  if (historyStorage == "auto") {
+    Natural<128> elementsCount(0);
+    for (auto key: A->getKeys()) {
+      elementsCount += A->get(key)->inspect()->getElementsCount();
+    }
+    // each entry holds the amplitudes and the residuum
+    Natural<128> historySize(N * 2 * elementsCount * sizeof(F));
+    Natural<128> memory(
+      Natural<128>(Cc4s::getMemoryShare(Cc4s::HISTORY_MEMORY)) *
+        Cc4s::getProcessesCount()
+    );
+    historyStorage = historySize <= memory ? "memory" : "disk";
+  }
+  LOG() << "historyStorage=" << historyStorage << std::endl;
+  if (historyStorage == "memory") {
+    fitMaxResiduaIntoMemory(A);
+  } else {
+    OUT() << "Storing DIIS history in " << historyDirectory << std::endl;
+    // the directory may be local to each node, all ranks check before
+    // any rank creates it
+    struct stat status;
+    bool existed(stat(historyDirectory.c_str(), &status) == 0);
+    Cc4s::world->barrier();
+    if (!existed) {
+      mkdir(historyDirectory.c_str(), 0755);
+      removeHistoryDirectory = true;
+    }
+    Cc4s::world->barrier();
+  }
+}
+
+template <typename F, typename TE>
+void DiisMixer<F,TE>::store(
+  const size_t i,
+  const Ptr<TensorSet<F,TE>> &A, const Ptr<TensorSet<F,TE>> &R
+) {
+  if (historyStorage == "memory") {
+    amplitudes[i] = A;
+    residua[i] = R;
+    return;
+  }
+  auto index(std::to_string(i));
+  auto rank(std::to_string(Cc4s::world->getRank()));
+  amplitudesFiles[i] =
+    historyDirectory + "/DiisAmplitudes" + index + "." + rank + ".bin";
+  residuaFiles[i] =
+    historyDirectory + "/DiisResiduum" + index + "." + rank + ".bin";
+  // wait for reads of the previous entry still pending
+  prefetched.erase(amplitudesFiles[i]);
+  prefetched.erase(residuaFiles[i]);
+  writeLocalEntry(amplitudesFiles[i], A);
+  writeLocalEntry(residuaFiles[i], R);
+}
+
+template <typename F, typename TE>
+void DiisMixer<F,TE>::writeLocalEntry(
+  const std::string &fileName, const Ptr<TensorSet<F,TE>> &entry
+) {
+  std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+  ASSERT(file, "Failed to open DIIS history file " + fileName);
+  auto &entryShapes(shapes[fileName]);
+  entryShapes.clear();
+  std::vector<size_t> indices;
+  std::vector<F> values;
+  for (auto key: entry->getKeys()) {
+    auto tensor(entry->get(key)->evaluate());
+    auto &shape(entryShapes[key]);
+    shape.name = tensor->getName();
+    shape.lens = tensor->getLens();
+    shape.dimensions = tensor->dimensions;
+    shape.metaData = tensor->getMetaData();
+    tensor->readLocal(indices, values);
+    Natural<> count(indices.size());
+    file.write(reinterpret_cast<const char *>(&count), sizeof(Natural<>));
+    file.write(
+      reinterpret_cast<const char *>(indices.data()), count * sizeof(size_t)
+    );
+    if (historyStorage == "compressed") {
+      auto words(reinterpret_cast<Real<64> *>(values.data()));
+      Natural<> wordsCount(count * sizeof(F) / sizeof(Real<64>));
+      ByteShuffleCodec::quantize(words, wordsCount, errorBound);
+      auto data(ByteShuffleCodec::encode(words, wordsCount));
+      Natural<> size(data.size());
+      file.write(reinterpret_cast<const char *>(&size), sizeof(Natural<>));
+      file.write(data.data(), size);
+    } else {
+      file.write(
+        reinterpret_cast<const char *>(values.data()), count * sizeof(F)
+      );
+    }
+  }
+  ASSERT(file, "Failed to write DIIS history file " + fileName);
+}
+
+template <typename F, typename TE>
+typename DiisMixer<F,TE>::LocalEntry DiisMixer<F,TE>::readLocalEntry(
+  const std::string &fileName, const std::vector<std::string> &keys,
+  const bool compressed
+) {
+  std::ifstream file(fileName, std::ios::binary);
+  ASSERT(file, "Failed to open DIIS history file " + fileName);
+  LocalEntry entry;
+  for (auto key: keys) {
+    auto &indices(entry[key].first);
+    auto &values(entry[key].second);
+    Natural<> count;
+    file.read(reinterpret_cast<char *>(&count), sizeof(Natural<>));
+    indices.resize(count);
+    values.resize(count);
+    file.read(reinterpret_cast<char *>(indices.data()), count*sizeof(size_t));
+    if (compressed) {
+      Natural<> size;
+      file.read(reinterpret_cast<char *>(&size), sizeof(Natural<>));
+      std::vector<char> data(size);
+      file.read(data.data(), size);
+      ByteShuffleCodec::decode(
+        data, reinterpret_cast<Real<64> *>(values.data()),
+        count * sizeof(F) / sizeof(Real<64>), SourceLocation(fileName, 0)
+      );
+    } else {
+      file.read(reinterpret_cast<char *>(values.data()), count * sizeof(F));
+    }
+  }
+  ASSERT(file, "Failed to read DIIS history file " + fileName);
+  return entry;
+}
+
+template <typename F, typename TE>
+void DiisMixer<F,TE>::prefetch(const std::string &fileName) {
+  if (historyStorage == "memory" || prefetched.count(fileName) > 0) return;
+  std::vector<std::string> keys;
+  for (auto &shape: shapes[fileName]) keys.push_back(shape.first);
+  prefetched[fileName] = std::async(
+    std::launch::async, readLocalEntry,
+    fileName, keys, historyStorage == "compressed"
+  );
+}
+
+template <typename F, typename TE>
+Ptr<TensorSet<F,TE>> DiisMixer<F,TE>::fetch(const std::string &fileName) {
+  LocalEntry entry;
+  auto pending(prefetched.find(fileName));
+  if (pending != prefetched.end()) {
+    entry = pending->second.get();
+    prefetched.erase(pending);
+  } else {
+    std::vector<std::string> keys;
+    for (auto &shape: shapes[fileName]) keys.push_back(shape.first);
+    entry = readLocalEntry(fileName, keys, historyStorage == "compressed");
+  }
+  // enter the local elements into tensors of the stored shapes
+  std::map<std::string, Ptr<TensorExpression<F,TE>>> components;
+  for (auto &shape: shapes[fileName]) {
+    auto tensor(
+      Tcc<TE>::template tensor<F>(shape.second.lens, shape.second.name)
+    );
+    tensor->dimensions = shape.second.dimensions;
+    tensor->getMetaData() = shape.second.metaData;
+    auto &elements(entry[shape.first]);
+    tensor->write(
+      elements.first.size(), elements.first.data(), elements.second.data()
+    );
+    components[shape.first] = tensor;
+  }
+  return New<TensorSet<F,TE>>(components);
+}
+
+template <typename F, typename TE>
+Ptr<MapNode> DiisMixer<F,TE>::writeState(const std::string &path) {
+  auto state(New<MapNode>(SOURCE_LOCATION));
+  state->setValue<Natural<>>("maxResidua", N);
+  state->setValue<Natural<>>("nextIndex", nextIndex);
+  state->setValue<Natural<>>("count", count);
+  // the overlap matrix has only real entries
+  std::vector<Real<>> overlaps;
+  for (auto b: B) overlaps.push_back(real(b));
+  state->get("overlaps") = New<ArrayNode<Real<>>>(overlaps, SOURCE_LOCATION);
+  auto history(New<MapNode>(SOURCE_LOCATION));
+  for (size_t i(0); i < N; ++i) {
+    bool inMemory(historyStorage == "memory");
+    if (inMemory ? !residua[i] : residuaFiles[i].empty()) continue;
+    auto index(std::to_string(i));
+    auto entry(New<MapNode>(SOURCE_LOCATION));
+    entry->setValue<std::string>(
+      "amplitudes", path + ".amplitudes" + index + ".yaml"
+    );
+    entry->setValue<std::string>(
+      "residuum", path + ".residuum" + index + ".yaml"
+    );
+    // entries on disk are copied one at a time
+    this->writeTensorSet(
+      entry->getValue<std::string>("amplitudes"),
+      inMemory ? amplitudes[i] : fetch(amplitudesFiles[i])
+    );
+    this->writeTensorSet(
+      entry->getValue<std::string>("residuum"),
+      inMemory ? residua[i] : fetch(residuaFiles[i])
+    );
+    history->get(i) = entry;
+  }
+  if (history->getSize() > 0) state->get("history") = history;
+  return state;
+}
+
+template <typename F, typename TE>
+void DiisMixer<F,TE>::readState(const Ptr<MapNode> &state) {
+  // the given maxResidua takes precedence over the one of the state
+  auto maxResidua(state->getValue<Natural<>>("maxResidua"));
+  if (!state->isGiven("history")) return;
+  auto history(state->getMap("history"));
+  bool isFirst(true);
+  for (auto key: history->getKeys()) {
+    auto entry(history->getMap(key));
+    auto A(this->readTensorSet(entry->getValue<std::string>("amplitudes")));
+    auto R(this->readTensorSet(entry->getValue<std::string>("residuum")));
+    if (isFirst) {
+      chooseHistoryStorage(A);
+      if (N != maxResidua) {
+        WARNING() << "Discarding DIIS history of " << maxResidua
+          << " residua, using maxResidua " << N << std::endl;
+        return;
+      }
+      isFirst = false;
+    }
+    store(std::stoul(key), A, R);
+  }
+  nextIndex = state->getValue<Natural<>>("nextIndex");
+  count = state->getValue<Natural<>>("count");
+  auto overlaps(state->getArray<Real<>>("overlaps"));
+  ASSERT_LOCATION(
+    overlaps->getSize() == B.size(), "Expecting (maxResidua+1)^2 overlaps",
+    overlaps->sourceLocation
+  );
+  for (size_t i(0); i < B.size(); ++i) B[i] = (*overlaps)[i];
+  LOG() << "Restored DIIS history of " << count << " residua" << std::endl;
+}
+
 template <typename F, typename TE>
 DiisMixer<F,TE>::~DiisMixer() {
+  // wait for pending reads, then remove the files of this rank without
+  // communicating, since not all ranks may be destroying their mixers
+  prefetched.clear();
+  for (auto fileNames: {&amplitudesFiles, &residuaFiles}) {
+    for (auto fileName: *fileNames) {
+      if (!fileName.empty()) std::remove(fileName.c_str());
+    }
+  }
+  // only succeeds for the last rank removing its files
+  if (removeHistoryDirectory) rmdir(historyDirectory.c_str());
 }
 
 template <typename F, typename TE>
 std::string DiisMixer<F,TE>::describeOptions() {
   std::stringstream stream;
-  stream << "maxResidua: " << N;
+  stream << "maxResidua: " << N << ", historyStorage: " << historyStorage;
   return stream.str();
 }
 
@@ -60,22 +355,48 @@ void DiisMixer<F,TE>::append(
   const Ptr<TensorSet<F,TE>> &A,
   const Ptr<TensorSet<F,TE>> &R
 ) {
+  // choose the storage of the history upon the first append
+  if (count == 0) chooseHistoryStorage(A);
 
   // replace amplidue and residuum at nextIndex
-  amplitudes[nextIndex] = A;
-  residua[nextIndex] = R;
+  store(nextIndex, A, R);
 
-  // write the overlap matrix for the new residua
-  for (size_t i(0); i < N; ++i) {
-    if (residua[i]) {
-      F overlap( 2.0*real(residua[i]->dot(*R)) );
-      size_t j((i+1)*(N+1)+nextIndex+1);
-      B[j] = overlap;
-      j = (nextIndex+1)*(N+1)+i+1;
-      B[j] = overlap;
+  // indices of the other entries of the history, most recent first
+  std::vector<size_t> storedIndices;
+  for (size_t j(1); j <= std::min(count, N-1); ++j) {
+    storedIndices.push_back((nextIndex+N-j) % N);
+  }
+
+  // overlaps of the new residuum with itself and with the history
+  std::vector<F> overlaps;
+  if (historyStorage == "memory") {
+    // computed in one batch
+    std::vector<Ptr<TensorSet<F,TE>>> storedResidua(1, R);
+    for (auto i: storedIndices) storedResidua.push_back(residua[i]);
+    overlaps = R->dot(storedResidua);
+  } else {
+    // computed one entry at a time, reading the next one in the background
+    overlaps.push_back(R->dot(*R));
+    for (size_t k(0); k < storedIndices.size(); ++k) {
+      if (k+1 < storedIndices.size()) {
+        prefetch(residuaFiles[storedIndices[k+1]]);
+      } else {
+        prefetch(amplitudesFiles[storedIndices[0]]);
+      }
+      overlaps.push_back(R->dot(*fetch(residuaFiles[storedIndices[k]])));
     }
   }
 
+  // write the overlap matrix for the new residuum
+  for (size_t k(0); k < overlaps.size(); ++k) {
+    auto i(k == 0 ? nextIndex : storedIndices[k-1]);
+    F overlap( 2.0*real(overlaps[k]) );
+    size_t j((i+1)*(N+1)+nextIndex+1);
+    B[j] = overlap;
+    j = (nextIndex+1)*(N+1)+i+1;
+    B[j] = overlap;
+  }
+
   // now, pseudo-invert upper left corner of B and read out its first column
   if (count < N) ++count;
   size_t dim(count+1);
@@ -89,19 +410,39 @@ void DiisMixer<F,TE>::append(
     column = inverse(matrix, dim);
   }
 
-  next = New<TensorSet<F,TE>>(*A);
-  *next *= F(0);
-  nextResiduum = New<TensorSet<F,TE>>(*R);
-  *nextResiduum *= F(0);
-//  OUT() << "\tDiis: ";
+  std::vector<F> coefficients;
   for (size_t j(0); j < count; ++j) {
     size_t i( (nextIndex+N-j) % N );
     LOG() << "w^(-" << (j+1) << ")=" << column[i+1] << std::endl;
-//    OUT() << "w^(-" << (j+1) << ")=" << column[i+1] << ", ";
-    *next += column[i+1] * *amplitudes[i];
-    *nextResiduum += column[i+1] * *residua[i];
+    coefficients.push_back(column[i+1]);
+  }
+  if (historyStorage == "memory") {
+    // build the next amplitudes and residuum in a single pass each
+    std::vector<Ptr<TensorSet<F,TE>>> combinedAmplitudes(1, A);
+    std::vector<Ptr<TensorSet<F,TE>>> combinedResidua(1, R);
+    for (auto i: storedIndices) {
+      combinedAmplitudes.push_back(amplitudes[i]);
+      combinedResidua.push_back(residua[i]);
+    }
+    next = TensorSet<F,TE>::linearCombination(coefficients, combinedAmplitudes);
+    nextResiduum =
+      TensorSet<F,TE>::linearCombination(coefficients, combinedResidua);
+  } else {
+    // accumulate one entry at a time, reading the next one in the background
+    next = TensorSet<F,TE>::linearCombination({coefficients[0]}, {A});
+    nextResiduum = TensorSet<F,TE>::linearCombination({coefficients[0]}, {R});
+    for (size_t k(0); k < storedIndices.size(); ++k) {
+      auto i(storedIndices[k]);
+      prefetch(residuaFiles[i]);
+      next->axpy(coefficients[k+1], *fetch(amplitudesFiles[i]));
+      if (k+1 < storedIndices.size()) {
+        prefetch(amplitudesFiles[storedIndices[k+1]]);
+      }
+      nextResiduum->axpy(coefficients[k+1], *fetch(residuaFiles[i]));
+    }
   }
-//  OUT() << std::endl;
+  // read the most recent residuum during the computation of the next one
+  if (N > 1) prefetch(residuaFiles[nextIndex]);
   nextIndex = (nextIndex+1) % N;
   residuumNorm = sqrt(real(nextResiduum->dot(*nextResiduum)));
 }
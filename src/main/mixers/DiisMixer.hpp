@@ -20,6 +20,10 @@
 
 #include <SharedPointer.hpp>
 
+#include <map>
+#include <string>
+#include <future>
+
 namespace cc4s {
   template <typename F, typename TE>
   class DiisMixer: public Mixer<F,TE> {
@@ -35,16 +39,20 @@ namespace cc4s {
     ) override ;
     Ptr<TensorSet<F,TE>> get() override;
     Real<> getResiduumNorm() override;
+    Ptr<MapNode> writeState(const std::string &path) override;
+    void readState(const Ptr<MapNode> &state) override;
 
     Ptr<TensorSet<F,TE>> next;
     Ptr<TensorSet<F,TE>> nextResiduum;
 
     /**
      * \brief The amplitudes associated to each residuum in the overlap matrix B
+     * if the history is kept in memory.
      **/
     std::vector<Ptr<TensorSet<F,TE>>> amplitudes;
     /**
      * \brief The residua contained in the overlap matrix B
+     * if the history is kept in memory.
      **/
     std::vector<Ptr<TensorSet<F,TE>>> residua;
     /**
@@ -61,6 +69,111 @@ namespace cc4s {
     size_t nextIndex;
     size_t count;
     Real<64> residuumNorm;
+    /**
+     * \brief Sets the number of residua to keep to the given value and
+     * empties the history.
+     **/
+    void setMaxResidua(const size_t maxResidua);
+    /**
+     * \brief Reduces the number of residua to keep, such that the
+     * history of amplitudes and residua of the given size fits into the
+     * history share of the memory of all ranks.
+     **/
+    void fitMaxResiduaIntoMemory(const Ptr<TensorSet<F,TE>> &A);
+
+    /**
+     * \brief Storage of the history of amplitudes and residua:
+     * memory, disk or compressed. By default, the history is kept in memory
+     * if it fits into the history share of the memory of all ranks and on
+     * disk otherwise.
+     * Disk and compressed storage keep only the current amplitudes and
+     * residuum in memory together with at most two entries of the history.
+     * Each rank writes the elements it stores locally to its own files.
+     **/
+    std::string historyStorage;
+    /**
+     * \brief Directory of the history files, which may be local to each
+     * node. It is created if needed and removed by the destructor if it
+     * did not exist before.
+     **/
+    std::string historyDirectory;
+    bool removeHistoryDirectory;
+    /**
+     * \brief Absolute error bound of the elements in compressed storage,
+     * zero for lossless compression.
+     **/
+    Real<> errorBound;
+    /**
+     * \brief File names of this rank of the amplitudes and residua of the
+     * history if it is not kept in memory.
+     **/
+    std::vector<std::string> amplitudesFiles, residuaFiles;
+    /**
+     * \brief Name, shape, dimensions and meta data of a component of an
+     * entry of the history, restored when reading the entry from files.
+     **/
+    class ComponentShape {
+    public:
+      std::string name;
+      std::vector<Natural<>> lens;
+      std::vector<Ptr<TensorDimension>> dimensions;
+      Ptr<MapNode> metaData;
+    };
+    /**
+     * \brief Shapes of the components of the entries, by their file name.
+     **/
+    std::map<std::string, std::map<std::string, ComponentShape>> shapes;
+    /**
+     * \brief Global indices and values of the elements of each component
+     * of an entry of the history stored locally on this rank.
+     **/
+    typedef std::map<
+      std::string, std::pair<std::vector<size_t>, std::vector<F>>
+    > LocalEntry;
+    /**
+     * \brief Entries of the history already being read in the background,
+     * by their file name.
+     **/
+    std::map<std::string, std::future<LocalEntry>> prefetched;
+
+    /**
+     * \brief Chooses the history storage upon the first append according
+     * to the memory needed for the history of amplitudes of the given size.
+     **/
+    void chooseHistoryStorage(const Ptr<TensorSet<F,TE>> &A);
+    /**
+     * \brief Enters the given amplitudes and residuum into the history at
+     * the given index.
+     **/
+    void store(
+      const size_t i,
+      const Ptr<TensorSet<F,TE>> &A, const Ptr<TensorSet<F,TE>> &R
+    );
+    /**
+     * \brief Writes the local elements of the given entry to the history
+     * file of the given name.
+     **/
+    void writeLocalEntry(
+      const std::string &fileName, const Ptr<TensorSet<F,TE>> &entry
+    );
+    /**
+     * \brief Reads the local elements of the components with the given
+     * keys from the history file of the given name. Does not communicate
+     * such that it can be called in the background.
+     **/
+    static LocalEntry readLocalEntry(
+      const std::string &fileName, const std::vector<std::string> &keys,
+      const bool compressed
+    );
+    /**
+     * \brief Starts reading the history file of the given name in the
+     * background.
+     **/
+    void prefetch(const std::string &fileName);
+    /**
+     * \brief Returns the entry of the history stored in the given file.
+     **/
+    Ptr<TensorSet<F,TE>> fetch(const std::string &fileName);
     std::vector<Real<64>> inverse(std::vector<Real<64>> matrix, size_t N);
     std::vector<Complex<64>> inverse(std::vector<Complex<64>> matrix, size_t N);
 
@@ -70,6 +70,28 @@ double LinearMixer<F,TE>::getResiduumNorm() {
   return residuumNorm;
 }
 
+template <typename F, typename TE>
+Ptr<MapNode> LinearMixer<F,TE>::writeState(const std::string &path) {
+  if (!last) return nullptr;
+  auto state(New<MapNode>(SOURCE_LOCATION));
+  state->setValue<std::string>("last", path + ".last.yaml");
+  state->setValue<std::string>("lastResiduum", path + ".lastResiduum.yaml");
+  this->writeTensorSet(state->getValue<std::string>("last"), last);
+  this->writeTensorSet(
+    state->getValue<std::string>("lastResiduum"), lastResiduum
+  );
+  return state;
+}
+
+template <typename F, typename TE>
+void LinearMixer<F,TE>::readState(const Ptr<MapNode> &state) {
+  last = this->readTensorSet(state->getValue<std::string>("last"));
+  lastResiduum = this->readTensorSet(
+    state->getValue<std::string>("lastResiduum")
+  );
+  residuumNorm = sqrt(real(lastResiduum->dot(*lastResiduum)));
+}
+
 // instantiate
 template class cc4s::LinearMixer<Real<64>, DefaultDryTensorEngine>;
 template class cc4s::LinearMixer<Complex<64>, DefaultDryTensorEngine>;
@@ -34,6 +34,8 @@ namespace cc4s {
     ) override ;
     Ptr<TensorSet<F,TE>> get() override;
     Real<> getResiduumNorm() override;
+    Ptr<MapNode> writeState(const std::string &path) override;
+    void readState(const Ptr<MapNode> &state) override;
 
     Ptr<TensorSet<F,TE>> last;
     Ptr<TensorSet<F,TE>> lastResiduum;
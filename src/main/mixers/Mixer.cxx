@@ -15,6 +15,8 @@
 
 #include <mixers/Mixer.hpp>
 #include <algorithms/Algorithm.hpp>
+#include <Reader.hpp>
+#include <Writer.hpp>
 
 using namespace cc4s;
 
@@ -26,6 +28,31 @@ template <typename F, typename TE>
 Mixer<F,TE>::~Mixer() {
 }
 
+template <typename F, typename TE>
+void Mixer<F,TE>::writeTensorSet(
+  const std::string &fileName, const Ptr<TensorSet<F,TE>> &tensorSet
+) {
+  auto options(New<MapNode>(SOURCE_LOCATION));
+  options->setValue<std::string>("elementsType", "IeeeBinaryFile");
+  Writer(fileName, options).write(
+    New<PointerNode<TensorSet<F,TE>>>(tensorSet, SOURCE_LOCATION)
+  );
+}
+
+template <typename F, typename TE>
+Ptr<TensorSet<F,TE>> Mixer<F,TE>::readTensorSet(const std::string &fileName) {
+  auto node(Reader(fileName).read()->toPtr<AtomicNode<Ptr<Object>>>());
+  ASSERT_LOCATION(
+    node, "Expecting TensorSet", SourceLocation(fileName, 0)
+  );
+  auto tensorSet(dynamicPtrCast<TensorSet<F,TE>>(node->value));
+  ASSERT_LOCATION(
+    tensorSet, "Expecting TensorSet of matching type",
+    SourceLocation(fileName, 0)
+  );
+  return tensorSet;
+}
+
 // instantiate
 template class cc4s::Mixer<Real<64>,DefaultDryTensorEngine>;
 template class cc4s::Mixer<Complex<64>,DefaultDryTensorEngine>;
@@ -68,7 +68,38 @@ namespace cc4s {
      **/
     virtual Real<> getResiduumNorm() = 0;
 
+    /**
+     * \brief Writes the state of the mixer into files starting with the
+     * given path and returns a map referring to them. A mixer of the same
+     * type continues identically after reading this map with readState.
+     * Returns nullptr if the mixer keeps no state.
+     **/
+    virtual Ptr<MapNode> writeState(const std::string &) {
+      return nullptr;
+    }
+
+    /**
+     * \brief Restores the state written by writeState. The settings
+     * given to this mixer take precedence, discarding any part of the
+     * state inconsistent with them.
+     **/
+    virtual void readState(const Ptr<MapNode> &) {
+    }
+
     Ptr<MapNode> arguments;
+
+  protected:
+    /**
+     * \brief Writes the given TensorSet with binary elements to the yaml
+     * file of the given name.
+     **/
+    static void writeTensorSet(
+      const std::string &fileName, const Ptr<TensorSet<F,TE>> &tensorSet
+    );
+    /**
+     * \brief Reads the TensorSet written by writeTensorSet.
+     **/
+    static Ptr<TensorSet<F,TE>> readTensorSet(const std::string &fileName);
   };
 
   template <typename F, typename TE>
@@ -266,8 +266,9 @@ namespace cc4s {
               ) {
                 bestContractions = allContractions;
                 if (level == 0) { // do output only in topmost level
-                  LOG_LOCATION(SourceLocation(scope.file, scope.line))
-                    << "possibilites tried: "
+                  LOG_CATEGORY_LOCATION(
+                    "tcc", 2, SourceLocation(scope.file, scope.line)
+                  ) << "possibilites tried: "
                     << scope.triedPossibilitiesCount
                     << ", improved solution found with "
                     << std::string(allContractions->costs)
@@ -277,8 +278,9 @@ namespace cc4s {
                 }
               } else {
                 if (level == 0) {
-                  LOG_LOCATION(SourceLocation(scope.file, scope.line))
-                    << "possibilites tried: "
+                  LOG_CATEGORY_LOCATION(
+                    "tcc", 3, SourceLocation(scope.file, scope.line)
+                  ) << "possibilites tried: "
                     << scope.triedPossibilitiesCount
                     << ", discarding inferior solution with "
                     << std::string(allContractions->costs)
@@ -375,7 +377,7 @@ namespace cc4s {
 
       if (outerElementsCount > std::numeric_limits<Natural<64>>::max()) {
         // overflow: result is definitely too big to be stored
-        LOG() << "Not considering contraction of "
+        LOG_CATEGORY("tcc", 2) << "Not considering contraction of "
           << a->getResult()->getName() << " and "
           << b->getResult()->getName()
           << ", Result would exceed 2^64 elements." << std::endl;
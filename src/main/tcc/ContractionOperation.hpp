@@ -63,7 +63,9 @@ namespace cc4s {
         this->template isOlderThan<F>(left) ||
         this->template isOlderThan<F>(right)
       ) {
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+        LOG_CATEGORY_LOCATION(
+          "tcc", 1, SourceLocation(this->file, this->line)
+        ) <<
           "executing: contraction " <<
           this->getName() << " <<= " <<
           this->alpha << " * " <<
@@ -80,7 +82,9 @@ namespace cc4s {
         this->updated();
         this->accountFlops(contractionCosts);
       } else {
-          LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+          LOG_CATEGORY_LOCATION(
+            "tcc", 2, SourceLocation(this->file, this->line)
+          ) <<
           this->getResult()->getName() << " up-to-date with " <<
           "(" << left->getName() << ", " << right->getName() << ")" <<
           std::endl;
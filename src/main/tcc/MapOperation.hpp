@@ -56,7 +56,9 @@ namespace cc4s {
     void execute() override {
       source->execute();
       if (this->template isOlderThan<Domain>(source)) {
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+        LOG_CATEGORY_LOCATION(
+          "tcc", 1, SourceLocation(this->file, this->line)
+        ) <<
           "executing: unary map " <<
           this->getName() << " <<= "<<
           "f(" << this->alpha << " * " << source->getName() << ") + " <<
@@ -72,7 +74,9 @@ namespace cc4s {
         this->updated();
         this->accountFlops();
       } else {
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+        LOG_CATEGORY_LOCATION(
+          "tcc", 2, SourceLocation(this->file, this->line)
+        ) <<
           this->getName() <<
           " up-to-date with " << source->getName() << std::endl;
       }
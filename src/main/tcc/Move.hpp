@@ -104,8 +104,9 @@ namespace cc4s {
     // each move has its private index namespace so disregard the outer
     // scope
     Ptr<Operation<TE>> compile(Scope &outerScope) override {
-      LOG_LOCATION(SourceLocation(outerScope.file, outerScope.line)) <<
-        "compiling: " << static_cast<std::string>(*this) << std::endl;
+      LOG_CATEGORY_LOCATION(
+        "tcc", 1, SourceLocation(outerScope.file, outerScope.line)
+      ) << "compiling: " << static_cast<std::string>(*this) << std::endl;
 
       // create a new namespace of indices
       Scope scope(outerScope.file, outerScope.line);
@@ -119,8 +120,9 @@ namespace cc4s {
         dynamicPtrCast<IndexedTensorOperation<F,TE>>(rhs->compile(scope))
       );
 
-      LOG_LOCATION(SourceLocation(outerScope.file, outerScope.line))
-        << "possibilites tried: " << scope.triedPossibilitiesCount
+      LOG_CATEGORY_LOCATION(
+        "tcc", 1, SourceLocation(outerScope.file, outerScope.line)
+      ) << "possibilites tried: " << scope.triedPossibilitiesCount
         << ", best has " << std::string(operation->costs)
         << ": " << std::string(*operation)
         << std::endl;
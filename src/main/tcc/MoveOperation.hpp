@@ -56,7 +56,9 @@ namespace cc4s {
     void execute() override {
       rhs->execute();
       if (this->template isOlderThan<F>(rhs)) {
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+        LOG_CATEGORY_LOCATION(
+          "tcc", 1, SourceLocation(this->file, this->line)
+        ) <<
           "executing: sum " <<
           this->getName() << " <<= " <<
           this->alpha << " * " << rhs->getName() << " + " <<
@@ -71,7 +73,9 @@ namespace cc4s {
         this->updated();
         this->accountFlops();
       } else {
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+        LOG_CATEGORY_LOCATION(
+          "tcc", 2, SourceLocation(this->file, this->line)
+        ) <<
           this->getName() << " up-to-date with " << rhs->getName() << std::endl;
       }
     }
@@ -46,7 +46,9 @@ namespace cc4s {
       // execute each operation in turn
       for (auto &operation: operations) {
         operation->execute();
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+        LOG_CATEGORY_LOCATION(
+          "tcc", 2, SourceLocation(this->file, this->line)
+        ) <<
           "Operations: " << this->getFloatingPointOperations() << std::endl;
       }
     }
@@ -53,21 +53,26 @@ namespace cc4s {
         auto aEnds(source->getResult()->getLens());
         auto aBegins(std::vector<size_t>(aEnds.size()));
 
-        std::stringstream beginsStream, endsStream, aBeginsStream, aEndsStream;
-        for (auto d: begins) { beginsStream << " " << d; }
-        for (auto d: ends) { endsStream << " " << d; }
-        for (auto d: aBegins) { aBeginsStream << " " << d; }
-        for (auto d: aEnds) { aEndsStream << " " << d; }
-
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
-          "executing: slice " <<
-          this->getName() << "(" <<
-            beginsStream.str() << "," << endsStream.str() <<
-          ") <<= " << this->alpha << " * " << source->getName() << "(" <<
-            aBeginsStream.str() << "," << aEndsStream.str() << ") + " <<
-          this->beta << " * " << this->getName() << "(" <<
-            beginsStream.str() << "," << endsStream.str() <<
-          ")" << std::endl;
+        if (Log::isLogged("tcc", 1)) {
+          std::stringstream
+            beginsStream, endsStream, aBeginsStream, aEndsStream;
+          for (auto d: begins) { beginsStream << " " << d; }
+          for (auto d: ends) { endsStream << " " << d; }
+          for (auto d: aBegins) { aBeginsStream << " " << d; }
+          for (auto d: aEnds) { aEndsStream << " " << d; }
+
+          LOG_CATEGORY_LOCATION(
+            "tcc", 1, SourceLocation(this->file, this->line)
+          ) <<
+            "executing: slice " <<
+            this->getName() << "(" <<
+              beginsStream.str() << "," << endsStream.str() <<
+            ") <<= " << this->alpha << " * " << source->getName() << "(" <<
+              aBeginsStream.str() << "," << aEndsStream.str() << ") + " <<
+            this->beta << " * " << this->getName() << "(" <<
+              beginsStream.str() << "," << endsStream.str() <<
+            ")" << std::endl;
+        }
 
         this->getResult()->getMachineTensor()->slice(
           F(1), source->getResult()->getMachineTensor(), aBegins, aEnds,
@@ -76,7 +81,9 @@ namespace cc4s {
         this->updated();
         this->accountFlops();
       } else {
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+        LOG_CATEGORY_LOCATION(
+          "tcc", 2, SourceLocation(this->file, this->line)
+        ) <<
           this->getName() <<
           "up-to-date with " << source->getName() << std::endl;
       }
@@ -53,21 +53,26 @@ namespace cc4s {
         auto bEnds(this->getResult()->getLens());
         auto bBegins(std::vector<size_t>(bEnds.size()));
 
-        std::stringstream beginsStream, endsStream, bBeginsStream, bEndsStream;
-        for (auto d: begins) { beginsStream << " " << d; }
-        for (auto d: ends) { endsStream << " " << d; }
-        for (auto d: bBegins) { bBeginsStream << " " << d; }
-        for (auto d: bEnds) { bEndsStream << " " << d; }
-
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
-          "executing: slice " <<
-          this->getName() << "(" <<
-            bBeginsStream.str() << "," << bEndsStream.str() <<
-          ") <<= " << this->alpha << " * " << source->getName() << "(" <<
-            beginsStream.str() << "," << endsStream.str() << ") + " <<
-          this->beta << " * " << this->getName() << "(" <<
-            bBeginsStream.str() << "," << bEndsStream.str() <<
-          ")" << std::endl;
+        if (Log::isLogged("tcc", 1)) {
+          std::stringstream
+            beginsStream, endsStream, bBeginsStream, bEndsStream;
+          for (auto d: begins) { beginsStream << " " << d; }
+          for (auto d: ends) { endsStream << " " << d; }
+          for (auto d: bBegins) { bBeginsStream << " " << d; }
+          for (auto d: bEnds) { bEndsStream << " " << d; }
+
+          LOG_CATEGORY_LOCATION(
+            "tcc", 1, SourceLocation(this->file, this->line)
+          ) <<
+            "executing: slice " <<
+            this->getName() << "(" <<
+              bBeginsStream.str() << "," << bEndsStream.str() <<
+            ") <<= " << this->alpha << " * " << source->getName() << "(" <<
+              beginsStream.str() << "," << endsStream.str() << ") + " <<
+            this->beta << " * " << this->getName() << "(" <<
+              bBeginsStream.str() << "," << bEndsStream.str() <<
+            ")" << std::endl;
+        }
 
         this->getResult()->getMachineTensor()->slice(
           F(1), source->getResult()->getMachineTensor(), begins, ends,
@@ -76,7 +81,9 @@ namespace cc4s {
         this->updated();
         this->accountFlops();
       } else {
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+        LOG_CATEGORY_LOCATION(
+          "tcc", 2, SourceLocation(this->file, this->line)
+        ) <<
           this->getName() <<
           " up-to-date with " << source->getName() << std::endl;
       }
@@ -27,7 +27,6 @@
 #include <SharedPointer.hpp>
 
 // TODO: binary function application
-// TODO: support hard memory limit for costs
 // TODO: looping over indices for memory reduction
 // TODO: automatic common subexpression optimization
 // TODO: heuristics: limit number of simultaneously considered intermediates
@@ -25,6 +25,7 @@
 #include <Cc4s.hpp>
 
 #include <cstdint>
+#include <functional>
 #include <vector>
 #include <string>
 #include <mpi.h>
@@ -311,6 +312,12 @@ namespace cc4s {
     typedef typename TE::template MachineTensor<F> MT;
     Ptr<MT> machineTensor;
 
+    /**
+     * \brief Deferred loader of the tensor elements, called once after
+     * the machine tensor is allocated, e.g. for lazily read tensors.
+     **/
+    std::function<void(const Ptr<Tensor<F,TE>> &)> loader;
+
   public:
     /**
      * \brief Create a tcc tensor of yet unknown shape.
@@ -369,7 +376,7 @@ namespace cc4s {
 
     ~Tensor() {
       if (allocated())
-        LOG() << "Free tensor " << name << " with " <<
+        LOG_CATEGORY("memory", 1) << "Free tensor " << name << " with " <<
           getElementsCount() << " elements" << std::endl;
     }
 
@@ -421,16 +428,32 @@ namespace cc4s {
         );
         // wait until allocation is done on all processes
         Cc4s::world->barrier();
-        LOG() << "Allocate tensor " << name << " with " <<
+        LOG_CATEGORY("memory", 1) << "Allocate tensor " << name << " with " <<
           getElementsCount() << " elements" << std::endl;
         // allocate the implementation specific machine tensor upon request
         machineTensor = MT::create(lens, name);
         // wait until allocation is done on all processes
         Cc4s::world->barrier();
+        if (loader) {
+          // load deferred elements into the now allocated machine tensor
+          auto load(loader);
+          loader = nullptr;
+          load(this->template toPtr<Tensor<F,TE>>());
+        }
       }
       return machineTensor;
     }
 
+    /**
+     * \brief Defers filling the elements of this tensor until its
+     * machine tensor is first requested.
+     **/
+    void setLoader(
+      const std::function<void(const Ptr<Tensor<F,TE>> &)> &loader_
+    ) {
+      loader = loader_;
+    }
+
     bool allocated() {
       return machineTensor != nullptr;
     }
@@ -480,6 +503,11 @@ namespace cc4s {
       Cc4s::world->broadcast(values);
       return values;
     }
+    // read the elements stored on this rank with their global indices,
+    // not collective
+    void readLocal(std::vector<size_t> &indices, std::vector<F> &values) {
+      getMachineTensor()->readLocal(indices, values);
+    }
     void readToFile(MPI_File &file, const size_t offset = 0) {
       getMachineTensor()->readToFile(file, offset);
     }
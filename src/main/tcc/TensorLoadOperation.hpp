@@ -49,7 +49,9 @@ namespace cc4s {
       if (source == this->getResult()) return;
       if (source->getVersion() > this->getResult()->getVersion()) {
         // move the data only if source and result tensors are different
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+        LOG_CATEGORY_LOCATION(
+          "tcc", 1, SourceLocation(this->file, this->line)
+        ) <<
           "executing: move " <<
           this->getName() << " <<= " << source->getName() << std::endl;
 
@@ -57,7 +59,9 @@ namespace cc4s {
         this->updated();
         this->accountFlops();
       } else {
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+        LOG_CATEGORY_LOCATION(
+          "tcc", 2, SourceLocation(this->file, this->line)
+        ) <<
           this->getName() <<
           " up-to-date with " << source->getName() << std::endl;
       }
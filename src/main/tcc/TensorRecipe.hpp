@@ -85,7 +85,9 @@ namespace cc4s {
       if (getLatestSourceVersion() >= this->result->getVersion()) {
         recipe->execute();
       } else {
-        LOG_LOCATION(SourceLocation(this->file, this->line)) <<
+        LOG_CATEGORY_LOCATION(
+          "tcc", 2, SourceLocation(this->file, this->line)
+        ) <<
           this->getName() << " up-to-date with all sources." << std::endl;
       }
     }
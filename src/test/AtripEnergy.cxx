@@ -0,0 +1,74 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <test/Test.hpp>
+#include <atrip/Atrip.hpp>
+#include <atrip/Equations.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace atrip;
+
+// amplitudes of one tuple for No occupied orbitals
+struct TupleAmplitudes {
+  std::vector<double> epsi, Tijk, Zijk;
+};
+
+static TupleAmplitudes getTupleAmplitudes(const size_t No) {
+  std::mt19937 generator(No);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  TupleAmplitudes tuple;
+  tuple.epsi.resize(No);
+  tuple.Tijk.resize(No*No*No);
+  tuple.Zijk.resize(No*No*No);
+  for (auto &e: tuple.epsi) e = -1.0 - uniform(generator);
+  for (auto &t: tuple.Tijk) t = uniform(generator);
+  for (auto &z: tuple.Zijk) z = uniform(generator);
+  return tuple;
+}
+
+TEST_CASE( "(T) energy kernels agree with the scalar kernel", "[atrip]" ) {
+  const energy::Isa detected(energy::isa());
+  const char *names[] = { "scalar", "avx2", "avx512" };
+  const double epsabc(3.0);
+  // No deliberately not a multiple of the 4 or 8 doubles per register,
+  // including rows longer than the tiles of 16 orbitals
+  for (size_t No: { 1, 3, 7, 13, 21, 35 }) {
+    auto tuple(getTupleAmplitudes(No));
+    energy::isa() = energy::Isa::Scalar;
+    const double
+      distinct(
+        getEnergyDistinct<double>(epsabc, tuple.epsi, tuple.Tijk, tuple.Zijk)
+      ),
+      same(
+        getEnergySame<double>(epsabc, tuple.epsi, tuple.Tijk, tuple.Zijk)
+      );
+    // lower the detected instruction set to each supported level
+    for (int isa(1); isa <= int(detected); ++isa) {
+      energy::isa() = energy::Isa(isa);
+      INFO( "No = " << No << ", instruction set " << names[isa] );
+      CHECK(
+        getEnergyDistinct<double>(epsabc, tuple.epsi, tuple.Tijk, tuple.Zijk)
+          == Approx(distinct).epsilon(1e-12)
+      );
+      CHECK(
+        getEnergySame<double>(epsabc, tuple.epsi, tuple.Tijk, tuple.Zijk)
+          == Approx(same).epsilon(1e-12)
+      );
+    }
+  }
+  energy::isa() = detected;
+}
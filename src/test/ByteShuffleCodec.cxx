@@ -0,0 +1,148 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <test/Test.hpp>
+#include <ByteShuffleCodec.hpp>
+#include <Complex.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace cc4s;
+
+// word counts deliberately not a multiple of the 8 streams
+static std::vector<Real<64>> getRealValues(const Natural<> count) {
+  std::mt19937 generator(4);
+  std::normal_distribution<Real<64>> distribution;
+  std::vector<Real<64>> values(count);
+  for (auto &value: values) value = distribution(generator);
+  return values;
+}
+
+static std::vector<Complex<64>> getComplexValues(const Natural<> count) {
+  std::mt19937 generator(8);
+  std::normal_distribution<Real<64>> distribution;
+  std::vector<Complex<64>> values(count);
+  for (auto &value: values) {
+    value = Complex<64>(distribution(generator), distribution(generator));
+  }
+  return values;
+}
+
+static std::vector<Real<64>> encodeAndDecode(
+  const Real<64> *values, const Natural<> count
+) {
+  auto encoded(ByteShuffleCodec::encode(values, count));
+  std::vector<Real<64>> decoded(count);
+  ByteShuffleCodec::decode(encoded, decoded.data(), count, SOURCE_LOCATION);
+  return decoded;
+}
+
+TEST_CASE( "ByteShuffleCodec lossless round trip", "[io]" ) {
+  if (!ByteShuffleCodec::isAvailable()) {
+    WARN("cc4s built without zlib, skipping");
+    return;
+  }
+  auto reals(getRealValues(1001));
+  auto decodedReals(encodeAndDecode(reals.data(), reals.size()));
+  REQUIRE(
+    std::memcmp(
+      decodedReals.data(), reals.data(), sizeof(Real<64>)*reals.size()
+    ) == 0
+  );
+
+  auto complexes(getComplexValues(333));
+  auto words(reinterpret_cast<const Real<64> *>(complexes.data()));
+  auto decodedComplexes(encodeAndDecode(words, 2*complexes.size()));
+  REQUIRE(
+    std::memcmp(
+      decodedComplexes.data(), words, sizeof(Complex<64>)*complexes.size()
+    ) == 0
+  );
+
+  // zero words are trivially compressible
+  std::vector<Real<64>> zeros(1001);
+  REQUIRE(
+    ByteShuffleCodec::encode(zeros.data(), zeros.size()).size() <
+      sizeof(Real<64>)*zeros.size()
+  );
+}
+
+TEST_CASE( "ByteShuffleCodec rejects malformed data", "[io]" ) {
+  if (!ByteShuffleCodec::isAvailable()) {
+    WARN("cc4s built without zlib, skipping");
+    return;
+  }
+  auto reals(getRealValues(1001));
+  auto encoded(ByteShuffleCodec::encode(reals.data(), reals.size()));
+  std::vector<Real<64>> decoded(reals.size());
+  auto truncated(encoded);
+  truncated.resize(encoded.size() / 2);
+  REQUIRE_THROWS(
+    ByteShuffleCodec::decode(
+      truncated, decoded.data(), decoded.size(), SOURCE_LOCATION
+    )
+  );
+  // decoding into a different number of words must fail
+  REQUIRE_THROWS(
+    ByteShuffleCodec::decode(
+      encoded, decoded.data(), decoded.size()-1, SOURCE_LOCATION
+    )
+  );
+}
+
+TEST_CASE( "ByteShuffleCodec lossy rounding within error bound", "[io]" ) {
+  const Real<64> errorBound(1e-6);
+  auto reals(getRealValues(1001));
+  auto quantizedReals(reals);
+  ByteShuffleCodec::quantize(
+    quantizedReals.data(), quantizedReals.size(), errorBound
+  );
+  for (Natural<> i(0); i < reals.size(); ++i) {
+    REQUIRE(std::abs(quantizedReals[i] - reals[i]) <= errorBound);
+  }
+
+  // complex values are rounded in their real and imaginary part
+  auto complexes(getComplexValues(333));
+  auto quantizedComplexes(complexes);
+  ByteShuffleCodec::quantize(
+    reinterpret_cast<Real<64> *>(quantizedComplexes.data()),
+    2*quantizedComplexes.size(), errorBound
+  );
+  for (Natural<> i(0); i < complexes.size(); ++i) {
+    auto error(quantizedComplexes[i] - complexes[i]);
+    REQUIRE(std::abs(std::real(error)) <= errorBound);
+    REQUIRE(std::abs(std::imag(error)) <= errorBound);
+  }
+
+  // a zero error bound leaves values unchanged
+  auto unchanged(reals);
+  ByteShuffleCodec::quantize(unchanged.data(), unchanged.size(), 0.0);
+  REQUIRE(unchanged == reals);
+
+  if (!ByteShuffleCodec::isAvailable()) return;
+  // rounded values are encoded exactly and compress
+  auto encoded(
+    ByteShuffleCodec::encode(quantizedReals.data(), quantizedReals.size())
+  );
+  REQUIRE(encoded.size() < sizeof(Real<64>)*quantizedReals.size());
+  std::vector<Real<64>> decoded(quantizedReals.size());
+  ByteShuffleCodec::decode(
+    encoded, decoded.data(), decoded.size(), SOURCE_LOCATION
+  );
+  REQUIRE(decoded == quantizedReals);
+}
@@ -0,0 +1,105 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <test/Test.hpp>
+#include <Node.hpp>
+
+using namespace cc4s;
+
+TEST_CASE( "Numeric arrays are converted within range", "[node]" ) {
+  auto map(New<MapNode>(SOURCE_LOCATION));
+  map->get("integers") = New<ArrayNode<Integer<64>>>(
+    std::vector<Integer<64>>({0, 3, 1l << 40}), SOURCE_LOCATION
+  );
+  auto naturals(map->getArray<Natural<>>("integers"));
+  REQUIRE(naturals->values == std::vector<Natural<>>({0, 3, 1ul << 40}));
+  // the converted array replaces the original one
+  REQUIRE(map->get("integers") == naturals);
+  auto reals(map->getArray<Real<>>("integers"));
+  REQUIRE(reals->values == std::vector<Real<>>({0.0, 3.0, 1099511627776.0}));
+
+  map->get("negative") = New<ArrayNode<Integer<64>>>(
+    std::vector<Integer<64>>({1, -1}), SOURCE_LOCATION
+  );
+  REQUIRE_THROWS(map->getArray<Natural<>>("negative"));
+  REQUIRE_THROWS(map->getArray<Natural<32>>("integers"));
+
+  map->get("fractional") = New<ArrayNode<Real<>>>(
+    std::vector<Real<>>({1.0, 2.5}), SOURCE_LOCATION
+  );
+  REQUIRE_THROWS(map->getArray<Integer<>>("fractional"));
+  map->get("integral") = New<ArrayNode<Real<>>>(
+    std::vector<Real<>>({-1.0, 2.0}), SOURCE_LOCATION
+  );
+  REQUIRE(
+    map->getArray<Integer<>>("integral")->values ==
+      std::vector<Integer<>>({-1, 2})
+  );
+}
+
+TEST_CASE( "Sequences of tuples are converted to tuple arrays", "[node]" ) {
+  auto map(New<MapNode>(SOURCE_LOCATION));
+  auto tuples(New<MapNode>(SOURCE_LOCATION));
+  for (Integer<64> i(0); i < 3; ++i) {
+    tuples->push_back(
+      New<ArrayNode<Integer<64>>>(
+        std::vector<Integer<64>>({i, 2*i}), SOURCE_LOCATION
+      )
+    );
+  }
+  REQUIRE(tuples->getSize() == 3);
+  map->get("tuples") = tuples;
+  auto tupleArray(map->getTupleArray<Natural<>>("tuples"));
+  REQUIRE(tupleArray->getSize() == 3);
+  REQUIRE(tupleArray->tupleSize == 2);
+  REQUIRE(tupleArray->getTuple(2) == std::vector<Natural<>>({2, 4}));
+  REQUIRE(tupleArray->getElementString(1) == "[1, 2]");
+
+  // tuple arrays of other types are converted
+  auto signedTuples(New<TupleArrayNode<Integer<64>>>(3, SOURCE_LOCATION));
+  signedTuples->values = {0, 1, 2, 3, 4, 5};
+  map->get("signed") = signedTuples;
+  auto naturalTuples(map->getTupleArray<Natural<>>("signed"));
+  REQUIRE(naturalTuples->tupleSize == 3);
+  REQUIRE(naturalTuples->getTuple(1) == std::vector<Natural<>>({3, 4, 5}));
+
+  // tuples of different lengths are rejected
+  tuples = New<MapNode>(SOURCE_LOCATION);
+  tuples->push_back(
+    New<ArrayNode<Integer<64>>>(std::vector<Integer<64>>({0}), SOURCE_LOCATION)
+  );
+  tuples->push_back(
+    New<ArrayNode<Integer<64>>>(
+      std::vector<Integer<64>>({0, 1}), SOURCE_LOCATION
+    )
+  );
+  map->get("ragged") = tuples;
+  REQUIRE_THROWS(map->getTupleArray<Natural<>>("ragged"));
+}
+
+TEST_CASE( "Map sizes count non-null elements", "[node]" ) {
+  auto map(New<MapNode>(SOURCE_LOCATION));
+  REQUIRE(map->getSize() == 0);
+  map->push_back(New<SymbolNode>("a", SOURCE_LOCATION));
+  map->push_back(New<SymbolNode>("b", SOURCE_LOCATION));
+  REQUIRE(map->getSize() == 2);
+  // looking up an absent key enters a null element
+  REQUIRE(!map->get("c"));
+  REQUIRE(map->getSize() == 2);
+  map->get("c") = New<SymbolNode>("c", SOURCE_LOCATION);
+  REQUIRE(map->getSize() == 3);
+  map->get("d") = New<SymbolNode>("d", SOURCE_LOCATION);
+  REQUIRE(map->getSize() == 4);
+}
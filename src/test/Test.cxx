@@ -16,15 +16,10 @@
 #define CATCH_CONFIG_RUNNER
 #include <test/Test.hpp>
 #include <Cc4s.hpp>
-#include <Parser.hpp>
-#include <util/MpiCommunicator.hpp>
-#include <util/Log.hpp>
+#include <MpiCommunicator.hpp>
+#include <Log.hpp>
 
 using namespace cc4s;
-using namespace CTF;
-
-World *Cc4s::world;
-Options *Cc4s::options;
 
 void printBanner() {
   OUT() << std::endl
@@ -38,16 +33,18 @@ void printBanner() {
     ", date=" << CC4S_DATE << std::endl;
   OUT() << "build date=" << __DATE__ << " " << __TIME__ << std::endl;
   OUT() << "compiler=" << COMPILER_VERSION << std::endl;
-  OUT() << "number of processes=" << Cc4s::world->np << std::endl << std::endl;
+  OUT() << "number of processes=" << Cc4s::world->getProcesses() <<
+    std::endl << std::endl;
 }
 
 
 int main(int argumentCount, char **arguments) {
   MPI_Init(&argumentCount, &arguments);
 
-  Cc4s::world = new World(argumentCount, arguments);
-  Cc4s::options = new Options(argumentCount, arguments);
-  Log::setRank(Cc4s::world->rank);
+  Cc4s::world = New<MpiCommunicator>();
+  // command line arguments are left to Catch, options keep their defaults
+  Cc4s::options = New<Options>(argumentCount, arguments);
+  Log::setRank(Cc4s::world->getRank());
 
   printBanner();
 
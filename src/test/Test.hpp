@@ -13,4 +13,7 @@
  * limitations under the License.
  */
 
+// the alternative signal stack of Catch needs a constant SIGSTKSZ,
+// which recent glibc versions no longer provide
+#define CATCH_CONFIG_NO_POSIX_SIGNALS
 #include <test/catch.hpp>
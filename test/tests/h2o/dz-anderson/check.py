@@ -0,0 +1,8 @@
+#!/usr/bin/env python3
+
+from testis import read_yaml, compare_energies
+
+out = read_yaml("cc4s.out.yaml")
+
+assert out["steps"][5]["out"]["convergenceReached"], "CCSD did not converge"
+compare_energies("correct.out.yaml", "cc4s.out.yaml", accuracy=1e-7)
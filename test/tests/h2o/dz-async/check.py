@@ -0,0 +1,18 @@
+#!/usr/bin/env python3
+
+from testis import compare_energies
+
+# the read waited for the background write to complete
+with open("cc4s.log") as f:
+    assert any(
+        "Waiting for background write of" in line and
+        "/AsyncVertex.elements" in line
+        for line in f
+    ), "read did not wait for the background write"
+
+with open("AsyncVertex.elements", "rb") as f:
+    written = f.read()
+with open("ReferenceVertex.elements", "rb") as f:
+    assert written == f.read(), "background written elements differ"
+
+compare_energies("correct.out.yaml", "cc4s.out.yaml", accuracy=1e-7)
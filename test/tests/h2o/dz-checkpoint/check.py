@@ -0,0 +1,36 @@
+#!/usr/bin/env python3
+
+import os
+import os.path as op
+from testis import compare_energies
+
+
+def read(fileName):
+    with open(fileName) as f:
+        return f.read()
+
+
+interrupted = read("interrupted.stdout")
+for iteration in [3, 6]:
+    assert "Writing checkpoint after iteration {}".format(iteration) \
+        in interrupted, "no checkpoint after iteration {}".format(iteration)
+
+for name in ["key", "mixer"]:
+    assert "Ignoring checkpoint" in read("mismatched-{}.log".format(name)), \
+        "checkpoint of mismatched {} not ignored".format(name)
+    assert "Resuming" not in read("mismatched-{}.stdout".format(name)), \
+        "resumed from checkpoint of mismatched {}".format(name)
+
+resumed = read("resumed.stdout")
+assert "Resuming from checkpoint checkpoints/Checkpoint1.yaml " \
+    "after iteration 6" in resumed, "not resumed after iteration 6"
+assert not any(
+    name.startswith("Checkpoint") for name in os.listdir("checkpoints")
+), "checkpoints not removed after convergence"
+
+# the resumed calculation must converge to the uninterrupted result
+testFolder = op.dirname(op.realpath(__file__))
+compare_energies(
+    op.join(testFolder, "..", "dz", "correct.out.yaml"), "resumed.out.yaml",
+    accuracy=1e-7
+)
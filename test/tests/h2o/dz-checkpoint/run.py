@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+
+import io
+import shutil
+from contextlib import redirect_stdout
+from testis import call
+
+
+def run(name, text):
+    with open(name + ".in", "w") as f:
+        f.write(text)
+    output = io.StringIO()
+    with redirect_stdout(output):
+        call("{{CC4S_RUN}} -i {0}.in -o {0}.out.yaml -l {0}.log".format(name))
+    with open(name + ".stdout", "w") as f:
+        f.write(output.getvalue())
+    print(output.getvalue())
+
+
+with open("cc4s.in") as f:
+    resumed = f.read()
+shutil.rmtree("checkpoints", ignore_errors=True)
+
+# stop before convergence, leaving the checkpoints after iterations 3 and 6
+coupledCluster = resumed.split("- name: PerturbativeTriples")[0]
+run("interrupted", coupledCluster.replace(
+    "maxIterations: 20", "maxIterations: 6"
+))
+
+# checkpoints of a different calculation or mixer must be ignored
+brief = coupledCluster.replace("maxIterations: 20", "maxIterations: 1")
+shutil.copytree("checkpoints", "checkpoints-key")
+run("mismatched-key", brief.replace(
+    "method: Ccsd", "method: Ccsd\n    ppl: false"
+).replace("checkpoints", "checkpoints-key"))
+shutil.copytree("checkpoints", "checkpoints-mixer")
+run("mismatched-mixer", brief.replace(
+    "type: DiisMixer", "type: LinearMixer"
+).replace("checkpoints", "checkpoints-mixer"))
+
+# resume until convergence
+run("resumed", resumed)
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+
+import os
+from array import array
+from testis import read_yaml
+
+
+def read_lens(fileName):
+    return [
+        int(dimension["length"])
+        for dimension in read_yaml(fileName)["dimensions"].values()
+    ]
+
+
+def read_elements(fileName):
+    elements = array("d")
+    with open(fileName, "rb") as f:
+        elements.frombytes(f.read())
+    return elements
+
+
+def read_types(fileName):
+    return [
+        dimension.get("type")
+        for dimension in read_yaml(fileName)["dimensions"].values()
+    ]
+
+
+def get_range(elements, lens, begins, ends):
+    # elements are stored first index fastest, words per element from size
+    count = 1
+    for length in lens:
+        count *= length
+    words = len(elements) // count
+    ranged = array("d")
+    position = list(begins)
+    while True:
+        index, stride = 0, 1
+        for d in range(len(lens)):
+            index += position[d] * stride
+            stride *= lens[d]
+        ranged.extend(elements[index*words:(index+1)*words])
+        d = 0
+        while d < len(lens):
+            position[d] += 1
+            if position[d] < ends[d]:
+                break
+            position[d] = begins[d]
+            d += 1
+        if d == len(lens):
+            return ranged
+
+
+def check_range(name, begins, ends):
+    lens = read_lens("Reference{}.yaml".format(name))
+    rangedLens = read_lens("Ranged{}.yaml".format(name))
+    assert rangedLens == [e - b for b, e in zip(begins, ends)], \
+        "ranged {} has wrong lengths {}".format(name, rangedLens)
+    # dimensions restricted to a range are named after it
+    for d, (entireType, rangedType) in enumerate(zip(
+        read_types("Reference{}.yaml".format(name)),
+        read_types("Ranged{}.yaml".format(name))
+    )):
+        if entireType is None:
+            continue
+        if begins[d] == 0 and ends[d] == lens[d]:
+            expected = entireType
+        else:
+            expected = "{}[{}:{}]".format(entireType, begins[d], ends[d])
+        assert rangedType == expected, \
+            "ranged {} dimension {} is {}, expecting {}".format(
+                name, d, rangedType, expected
+            )
+    reference = read_elements("Reference{}.elements".format(name))
+    ranged = read_elements("Ranged{}.elements".format(name))
+    assert ranged == get_range(reference, lens, begins, ends), \
+        "ranged {} elements differ".format(name)
+
+
+# reading entire chunked files is exact
+assert read_elements("ReadVertex.elements") == \
+    read_elements("ReferenceVertex.elements"), "read vertex differs"
+
+vertexLens = read_lens("ReferenceVertex.yaml")
+check_range("Energies", [2], [7])
+check_range(
+    "Vertex", [0, 2, 3], [vertexLens[0], vertexLens[1] - 2, vertexLens[2]]
+)
+
+# the detected checksum mismatch is reported
+with open("corrupted.log") as f:
+    assert "Checksum mismatch" in f.read(), "corrupted chunk not reported"
+
+# the rewritten vertex file holds only the energies
+with open("ChunkedVertex.elements", "rb") as f:
+    rewritten = f.read()
+with open("ChunkedEnergies.elements", "rb") as f:
+    assert rewritten == f.read(), "rewritten file differs from the energies"
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+
+import shutil
+from testis import call, read_yaml
+
+# write chunked files and read them back entirely
+call("{CC4S_RUN} -i cc4s.in")
+
+# read a range of the vertex, its extent is only known from the file
+lens = [
+    int(dimension["length"])
+    for dimension in read_yaml("ChunkedVertex.yaml")["dimensions"].values()
+]
+begins = [0, 2, 3]
+ends = [lens[0], lens[1] - 2, lens[2]]
+with open("ranged.in", "w") as f:
+    f.write("""- name: Read
+  in:
+    fileName: "ChunkedVertex.yaml"
+    begins: {}
+    ends: {}
+  out:
+    destination: RangedVertex
+
+- name: Write
+  in:
+    source: RangedVertex
+    fileName: "RangedVertex.yaml"
+    elementsType: IeeeBinaryFile
+  out: {{}}
+""".format(begins, ends))
+call("{CC4S_RUN} -i ranged.in -o ranged.out.yaml -l ranged.log")
+
+# a corrupted chunk must be detected
+shutil.copy("ChunkedVertex.yaml", "CorruptedVertex.yaml")
+shutil.copy("ChunkedVertex.elements", "CorruptedVertex.elements")
+with open("CorruptedVertex.elements", "r+b") as f:
+    f.seek(-1, 2)
+    lastByte = f.read(1)
+    f.seek(-1, 2)
+    f.write(bytes([lastByte[0] ^ 0xff]))
+with open("corrupted.in", "w") as f:
+    f.write("""- name: Read
+  in:
+    fileName: "CorruptedVertex.yaml"
+  out:
+    destination: CorruptedVertex
+""")
+try:
+    call("{CC4S_RUN} -i corrupted.in -o corrupted.out.yaml -l corrupted.log")
+except Exception:
+    pass
+else:
+    raise Exception("Reading a corrupted chunk did not fail")
+
+# rewrite the shorter energies over the longer vertex file
+with open("rewrite.in", "w") as f:
+    f.write("""- name: Read
+  in:
+    fileName: "ChunkedEnergies.yaml"
+  out:
+    destination: EigenEnergies
+
+- name: Write
+  in:
+    source: EigenEnergies
+    fileName: "ChunkedVertex.yaml"
+    elementsType: ChunkedBinaryFile
+  out: {}
+""")
+call("{CC4S_RUN} -i rewrite.in -o rewrite.out.yaml -l rewrite.log")
@@ -0,0 +1,33 @@
+#!/usr/bin/env python3
+
+import os
+from array import array
+from testis import read_yaml
+
+
+def read_elements(fileName):
+    elements = array("d")
+    with open(fileName, "rb") as f:
+        elements.frombytes(f.read())
+    return elements
+
+
+errorBound = 1e-6
+for name in ["Energies", "Vertex"]:
+    reference = read_elements("Reference{}.elements".format(name))
+    # lossless compression is exact
+    assert read_elements("LosslessRead{}.elements".format(name)) == \
+        reference, "lossless {} differ".format(name)
+    # lossy compression rounds each real and imaginary part within the bound
+    lossy = read_elements("LossyRead{}.elements".format(name))
+    assert len(lossy) == len(reference), "lossy {} size differs".format(name)
+    error = max(abs(x - y) for x, y in zip(lossy, reference))
+    assert error <= errorBound, \
+        "lossy {} error {} exceeds {}".format(name, error, errorBound)
+    elements = read_yaml("Lossy{}.yaml".format(name))["elements"]
+    assert float(elements["errorBound"]) == errorBound, \
+        "error bound of {} not recorded".format(name)
+
+# rounded vertex elements compress
+assert os.path.getsize("LossyVertex.elements") < \
+    os.path.getsize("ReferenceVertex.elements"), "lossy vertex not compressed"
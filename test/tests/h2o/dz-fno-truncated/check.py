@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+
+import numpy as np
+from testis import read_yaml
+
+# second order energy in the retained frozen natural orbitals computed
+# independently from the elements of the input tensors
+particlesCount = 20
+degeneracy = 2
+
+
+def read_tensor(name):
+    tensor = read_yaml(name + ".yaml")
+    # dimensions are given as sequence or as map by index
+    dimensions = tensor["dimensions"]
+    if isinstance(dimensions, dict):
+        dimensions = dimensions.values()
+    lens = [int(dimension["length"]) for dimension in dimensions]
+    isComplex = tensor["scalarType"] == "Complex64"
+    elements = np.fromfile(
+        name + ".elements", dtype="<c16" if isComplex else "<f8"
+    )
+    # elements are stored first index fastest
+    return elements.reshape(lens, order="F"), tensor.get("metaData") or {}
+
+
+def get_integrals(GammaGph):
+    Vpphh = np.einsum("Gai,Gbj->abij", GammaGph.conj(), GammaGph)
+    return Vpphh.real if isHalfGrid else Vpphh
+
+
+def get_denominators(epsp, epsh):
+    return (
+        epsp[:, None, None, None] + epsp[None, :, None, None] -
+        epsh[None, None, :, None] - epsh[None, None, None, :]
+    )
+
+
+eps, energiesMetaData = read_tensor("EigenEnergies")
+No = int(np.sum(eps < float(energiesMetaData["fermiEnergy"])))
+epsh, epsp = eps[:No], eps[No:]
+Nv = len(epsp)
+assert particlesCount < Nv, "not truncating {} particles".format(Nv)
+GammaGqr, vertexMetaData = read_tensor("CoulombVertex")
+isHalfGrid = bool(int(vertexMetaData.get("halfGrid", 0)))
+GammaGph = GammaGqr[:, No:, :No]
+
+# particle density of the first order doubles amplitudes
+Tpphh = get_integrals(GammaGph).conj() / get_denominators(epsp, epsh)
+Dpp = (
+    degeneracy * np.einsum("acij,bcij->ab", Tpphh, Tpphh.conj()) -
+    np.einsum("acij,cbij->ab", Tpphh, Tpphh.conj())
+)
+occupations, orbitals = np.linalg.eigh(Dpp)
+# semicanonical orbitals spanning the most occupied natural orbitals
+naturalOrbitals = orbitals[:, ::-1][:, :particlesCount].conj()
+fock = naturalOrbitals.conj().T @ np.diag(epsp) @ naturalOrbitals
+epsx, semicanonical = np.linalg.eigh(fock)
+C = naturalOrbitals @ semicanonical
+
+rotatedGammaGph = np.einsum("ax,Gai->Gxi", C.conj(), GammaGph)
+Vxyij = get_integrals(rotatedGammaGph)
+Txyij = Vxyij.conj() / get_denominators(epsx, epsh)
+reference = {
+    "direct": -0.5 * degeneracy**2 * np.sum(Vxyij * Txyij).real,
+    "exchange": 0.5 * degeneracy *
+    np.sum(Vxyij.transpose(0, 1, 3, 2) * Txyij).real
+}
+
+out = read_yaml("cc4s.out.yaml")
+assert int(out["steps"][5]["out"]["particlesCount"]) == particlesCount, \
+    "wrong number of retained particles"
+energy = out["steps"][7]["out"]["energy"]
+for name, value in reference.items():
+    assert abs(float(energy[name]) - value) < 1e-8, \
+        "{} energy {} differs from reference {}".format(
+            name, energy[name], value
+        )
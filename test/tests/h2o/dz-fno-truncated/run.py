@@ -0,0 +1,5 @@
+#!/usr/bin/env python3
+
+from testis import call
+
+call("{CC4S_RUN} -i cc4s.in")
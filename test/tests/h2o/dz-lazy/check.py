@@ -0,0 +1,30 @@
+#!/usr/bin/env python3
+
+from testis import compare_energies
+
+with open("cc4s.stdout") as f:
+    lines = f.read().splitlines()
+
+
+def find_line(text):
+    for i, line in enumerate(lines):
+        if text in line:
+            return i
+    return None
+
+
+# elements of lazily read tensors are only read when first used
+for name in ["CoulombVertex", "UnusedVertex"]:
+    assert find_line("Deferring reading of {}.elements".format(name)) \
+        is not None, "reading of {} not deferred".format(name)
+vertexRead = find_line("/CoulombVertex.elements")
+assert vertexRead is not None, "vertex not read"
+assert vertexRead > find_line("step: 4, DefineHolesAndParticles"), \
+    "vertex read before its first use"
+assert find_line("/UnusedVertex.elements") is None, "unused vertex read"
+
+with open("rewritten.log") as f:
+    assert "changed since it was read lazily" in f.read(), \
+        "rewritten file not reported"
+
+compare_energies("correct.out.yaml", "cc4s.out.yaml", accuracy=1e-7)
@@ -0,0 +1,27 @@
+#!/usr/bin/env python3
+
+import io
+import shutil
+from contextlib import redirect_stdout
+from testis import call
+
+# copies of the vertex, one is never used, the other is rewritten
+for name in ["UnusedVertex", "RewrittenVertex"]:
+    shutil.copy("CoulombVertex.yaml", name + ".yaml")
+    shutil.copy("CoulombVertex.elements", name + ".elements")
+
+# keep the output to check when elements are read
+output = io.StringIO()
+with redirect_stdout(output):
+    call("{CC4S_RUN} -i cc4s.in")
+with open("cc4s.stdout", "w") as f:
+    f.write(output.getvalue())
+print(output.getvalue())
+
+# a lazily read file rewritten before its first use must be detected
+try:
+    call("{CC4S_RUN} -i rewritten.in -o rewritten.out.yaml -l rewritten.log")
+except Exception:
+    pass
+else:
+    raise Exception("Using a rewritten lazily read file did not fail")
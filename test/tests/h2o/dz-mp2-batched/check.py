@@ -0,0 +1,13 @@
+#!/usr/bin/env python3
+
+from testis import read_yaml, compare_energies
+
+out = read_yaml("cc4s.out.yaml")
+
+# the batched energy must match the one from the entire integrals
+unbatched = out["steps"][5]["out"]["energy"]
+batched = out["steps"][6]["out"]["energy"]
+for name in ["direct", "exchange", "secondOrder"]:
+    assert abs(float(batched[name]) - float(unbatched[name])) < 1e-10, \
+        "batched {} energy differs".format(name)
+compare_energies("correct.out.yaml", "cc4s.out.yaml", accuracy=1e-7)
@@ -0,0 +1,9 @@
+#!/usr/bin/env python3
+
+from testis import compare_energies
+
+with open("cc4s.log") as f:
+    assert "Contracting Coulomb integrals ppph through the vertex" \
+        in f.read(), "Vppph not contracted through the vertex"
+
+compare_energies("correct.out.yaml", "cc4s.out.yaml", accuracy=1e-7)
@@ -0,0 +1,6 @@
+#!/usr/bin/env python3
+
+from testis import call
+
+# the slices share of a quarter of the memory given is smaller than Vppph
+call("{CC4S_RUN} -i cc4s.in -m 2M")
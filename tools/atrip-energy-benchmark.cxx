@@ -0,0 +1,88 @@
+/* Copyright 2021 cc4s.org
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Microbenchmark of the (T) energy kernels of atrip for a single tuple,
+ * timing every instruction set available on the running machine.
+ * Build it with the same configuration as Cc4s, e.g.
+ *
+ *   make atrip-energy-benchmark CONFIG=gcc-oblas-ompi
+ *
+ * and run build/<config>/bin/atrip-energy-benchmark without arguments
+ * for No = 50, 100, ..., 300.
+ */
+
+#include <atrip/Atrip.hpp>
+#include <atrip/Equations.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace atrip;
+
+template <typename F>
+double timeEnergy(
+  F (*energy)(F, std::vector<F> const&, std::vector<F> const&,
+    std::vector<F> const&),
+  std::vector<F> const& epsi, std::vector<F> const& Tijk,
+  std::vector<F> const& Zijk, const size_t repetitions
+) {
+  double sum(0.0);
+  // warm up buffers and caches
+  sum += energy(F(3.0), epsi, Tijk, Zijk);
+  auto start(std::chrono::high_resolution_clock::now());
+  for (size_t r(0); r < repetitions; ++r) {
+    sum += energy(F(3.0) + F(r), epsi, Tijk, Zijk);
+  }
+  std::chrono::duration<double> elapsed(
+    std::chrono::high_resolution_clock::now() - start
+  );
+  // keep the result alive
+  if (sum == 0.123456789) std::printf(" ");
+  return elapsed.count() / repetitions;
+}
+
+int main() {
+  const char *names[] = { "scalar", "avx2", "avx512" };
+  const energy::Isa detected(energy::isa());
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::printf("%6s %8s %12s %12s %10s\n",
+    "No", "isa", "distinct/ms", "same/ms", "ns/ijk");
+  for (size_t No(50); No <= 300; No += 50) {
+    std::vector<double> epsi(No), Tijk(No*No*No), Zijk(No*No*No);
+    for (auto &e: epsi) e = -1.0 - uniform(generator);
+    for (auto &t: Tijk) t = uniform(generator);
+    for (auto &z: Zijk) z = uniform(generator);
+    const size_t repetitions(std::max<size_t>(1, 2e8 / (No*No*No)));
+    for (int isa(0); isa <= int(detected); ++isa) {
+      energy::isa() = energy::Isa(isa);
+      const double
+        distinct(timeEnergy<double>(
+          getEnergyDistinct<double>, epsi, Tijk, Zijk, repetitions
+        )),
+        same(timeEnergy<double>(
+          getEnergySame<double>, epsi, Tijk, Zijk, repetitions
+        )),
+        elements(No*(No+1)*(No+2) / 6.0);
+      std::printf("%6zu %8s %12.4f %12.4f %10.3f\n",
+        No, names[isa], distinct*1e3, same*1e3, distinct*1e9 / elements);
+    }
+  }
+  energy::isa() = detected;
+  return 0;
+}